@@ -0,0 +1,114 @@
+#include <iostream>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include "xiangqi.h"
+#include "genetic.h"
+
+// Lazy SMP speedup report. Measures time-to-depth over a few positions at 1/2/4/8/16/32 threads.
+// Also checks that the search itself does not touch the heap and that the network's accumulators stay exact, and exits with 1 if
+// either fails.
+// Usage: bench [depth] [network.nnue]
+
+// Every heap allocation in the program goes through here. None of these are inlined: GCC would then see malloc() meet operator
+// delete, or operator new meet free(), and report a mismatched pair (-Wmismatched-new-delete). The array forms fall back to these.
+std::atomic<long long> allocations(0);
+
+__attribute__((noinline)) void* operator new(std::size_t size) {
+	allocations++;
+	void* p = std::malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+	int depth = (argc > 1) ? atoi(argv[1]) : 3;
+
+	XAI ai(1.465682, 0.377270, 1.772698, 0.043397, 0.140934, -1.568957, 0.009095, -0.374828, 0.744469, 1000.000000, 0.062204); // Reigning champion
+	if (argc > 2) {
+		ai.network = std::make_shared<XNetwork>(argv[2]);
+		if (!ai.network->loaded()) {
+			std::cout << "COULD NOT LOAD " << argv[2] << "\n";
+			return 1;
+		}
+	}
+
+	// Opening, plus a few middlegame positions reached by self-play
+	std::vector<XGame> positions;
+	XGame game;
+	positions.push_back(game);
+	for (int i = 0; i < 24 && !game.gameover(); i++) {
+		auto move = ai.pick(game);
+		game.execute(move.first, move.second);
+		game.sidetomove = !game.sidetomove;
+		if (i % 8 == 7) positions.push_back(game);
+	}
+
+	ai.searchdepth = depth;
+	double base = 0;
+	int threadcounts[6] = {1, 2, 4, 8, 16, 32};
+	std::cout << "DEPTH " << depth << " POSITIONS " << positions.size() << " HARDWARE THREADS " << std::thread::hardware_concurrency() << "\n";
+	for (int t : threadcounts) {
+		ai.threads = t;
+		int leaves = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (auto p : positions) {
+			ai.newGame(); // Every run starts cold, pick() would otherwise reuse the table of the previous one
+			ai.pick(p);
+			leaves += ai.leafcount;
+		}
+		double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (t == 1) base = secs;
+		std::cout << "THREADS " << t << " TIME " << secs << "s LEAVES " << leaves << " SPEEDUP " << (base / secs) << "\n";
+	}
+
+	// Zero allocation check. One warm-up search sizes the arena, after that a search of the same depth must not allocate at all.
+	// Iterative deepening itself keeps a few small per-iteration results, so this calls abprune directly.
+	ai.threads = 1;
+	long long total = 0;
+	for (auto p : positions) {
+		ai.abprune(p, depth, -XAI::MAXSCORE, XAI::MAXSCORE);
+		long long before = allocations;
+		ai.abprune(p, depth, -XAI::MAXSCORE, XAI::MAXSCORE);
+		total += allocations - before;
+	}
+	std::cout << "HEAP ALLOCATIONS DURING SEARCH " << total << "\n";
+
+	// Network check. A random network comes back the same from a save and a load (through bench.nnue in the working directory), and
+	// the accumulators updated move by move, as the search does, match ones rebuilt from the board along random games.
+	XRandom rng(1);
+	XNetwork random;
+	random.randomize(rng);
+	XNetwork loaded;
+	bool same = random.save("bench.nnue") && loaded.load("bench.nnue") && loaded.ftweights == random.ftweights && loaded.scale == random.scale &&
+		std::memcmp(loaded.ftbias, random.ftbias, sizeof(random.ftbias)) == 0 && std::memcmp(loaded.outweights, random.outweights, sizeof(random.outweights)) == 0 &&
+		loaded.outbias == random.outbias;
+	std::remove("bench.nnue");
+	const XNetwork& net = ai.network ? *ai.network : random;
+	int checked = 0;
+	int mismatches = 0;
+	for (int g = 0; g < 100; g++) {
+		XGame game;
+		XAccumulator acc;
+		acc.refresh(net, game);
+		for (int i = 0; i < 150 && !game.gameover(); i++) {
+			auto moves = game.getAllLegalMoves();
+			auto move = moves[rng.nextInt(moves.size())];
+			game.execute(move.first, move.second);
+			game.sidetomove = !game.sidetomove;
+			XAccumulator parent = acc;
+			acc.update(net, parent, game, move);
+			XAccumulator fresh;
+			fresh.refresh(net, game);
+			checked++;
+			if (std::memcmp(acc.v, fresh.v, sizeof(acc.v)) != 0 || acc.bucket[0] != fresh.bucket[0] || acc.bucket[1] != fresh.bucket[1]) mismatches++;
+		}
+	}
+	std::cout << "NETWORK " << (same ? "SAVED AND LOADED" : "CHANGED BY SAVE AND LOAD") << ", ACCUMULATOR MISMATCHES " << mismatches << " IN " << checked << " POSITIONS\n";
+
+	return (total || !same || mismatches) ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "xiangqi.h"
+#include "genetic.h"
+#include "book.h"
+
+// Opening book builder.
+// Usage: book <out.bin> [games] [plies] [seed] [records.txt]
+// Without a records file it plays games of self-play opening moves: at every ply the champion's top 3 moves go into the book, the
+// best weighted highest, and one of them is played. A records file has one game per line in the notation pick() prints
+// (e.g. "h3e3 h10g8 ..."), and every move of its first plies is added with weight 1.
+
+// "h3e3" -> ((7, 2), (-3, 0)). Ranks can have two digits.
+bool parseMove(const std::string& s, std::pair<std::pair<int, int>, std::pair<int, int>>& move) {
+	int sx, sy, ex, ey;
+	size_t i = 0;
+	if (i >= s.size() || s[i] < 'a' || s[i] > 'i') return false;
+	sx = s[i++] - 'a';
+	sy = 0;
+	while (i < s.size() && isdigit(s[i])) sy = sy * 10 + (s[i++] - '0');
+	if (i >= s.size() || s[i] < 'a' || s[i] > 'i') return false;
+	ex = s[i++] - 'a';
+	ey = 0;
+	while (i < s.size() && isdigit(s[i])) ey = ey * 10 + (s[i++] - '0');
+	if (i != s.size() || sy < 1 || ey < 1) return false;
+	move = {{sx, sy - 1}, {ex - sx, ey - sy}};
+	return true;
+}
+
+XBookEntry record(XGame& game, std::pair<std::pair<int, int>, std::pair<int, int>> move, uint32_t weight) {
+	XBookEntry e;
+	e.key = game.hash();
+	e.sx = move.first.first;
+	e.sy = move.first.second;
+	e.dx = move.second.first;
+	e.dy = move.second.second;
+	e.weight = weight;
+	return e;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cout << "USAGE: book <out.bin> [games] [plies] [seed] [records.txt]\n";
+		return 1;
+	}
+	std::string out = argv[1];
+	int games = (argc > 2) ? atoi(argv[2]) : 64;
+	int plies = (argc > 3) ? atoi(argv[3]) : 8;
+	uint64_t seed = (argc > 4) ? strtoull(argv[4], nullptr, 10) : time(0);
+	std::cout << "SEED " << seed << "\n";
+	XRandom rng(seed);
+
+	std::vector<XBookEntry> records;
+
+	if (argc > 5) {
+		std::ifstream in(argv[5]);
+		std::string line;
+		int read = 0;
+		while (std::getline(in, line)) {
+			std::istringstream ss(line);
+			std::string token;
+			XGame game;
+			for (int i = 0; i < plies && ss >> token; i++) {
+				std::pair<std::pair<int, int>, std::pair<int, int>> move;
+				if (!parseMove(token, move) || !game.legal(move.first, move.second)) break;
+				records.push_back(record(game, move, 1));
+				game.execute(move.first, move.second);
+				game.sidetomove = !game.sidetomove;
+			}
+			read++;
+		}
+		std::cout << "READ " << read << " GAMES\n";
+	}
+	else {
+		XAI ai(1.465682, 0.377270, 1.772698, 0.043397, 0.140934, -1.568957, 0.009095, -0.374828, 0.744469, 1000.000000, 0.062204); // Reigning champion
+		ai.rng.seed(rng.next());
+		for (int g = 0; g < games; g++) {
+			XGame game;
+			ai.newGame();
+			for (int i = 0; i < plies && !game.gameover(); i++) {
+				std::vector<XSearchResult> lines = ai.pickMulti(game, 3);
+				if (lines.empty()) break;
+				for (int k = 0; k < (int)lines.size(); k++) records.push_back(record(game, lines[k].move, (uint32_t)(lines.size() - k)));
+				auto move = lines[rng.nextInt(lines.size())].move;
+				game.execute(move.first, move.second);
+				game.sidetomove = !game.sidetomove;
+			}
+			std::cout << "X" << std::flush;
+		}
+		std::cout << "\n";
+	}
+
+	if (!XBook::write(out, records)) {
+		std::cout << "COULD NOT WRITE " << out << "\n";
+		return 1;
+	}
+
+	XBook book(out);
+	std::cout << "WROTE " << book.count << " BOOK MOVES TO " << out << "\n";
+	return 0;
+}
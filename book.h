@@ -0,0 +1,141 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include "xiangqi.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define XBOOK_MMAP
+#endif
+
+// Opening book. The file is a flat array of 16 byte records sorted by position hash (XGame::hash(), side to move included), several
+// records per position when there are several book moves. Records are written in host byte order.
+// Where mmap is available the file is mapped read-only, so any number of engines and threads share one copy of it.
+struct XBookEntry {
+	uint64_t key;
+	int8_t sx, sy, dx, dy; // Source square and move vector
+	uint32_t weight;
+
+	std::pair<std::pair<int, int>, std::pair<int, int>> move() { return {{sx, sy}, {dx, dy}}; }
+	bool operator<(const XBookEntry& other) const { return key < other.key; }
+};
+
+static_assert(sizeof(XBookEntry) == 16, "book records are 16 bytes on disk");
+
+class XBook {
+	public:
+	const XBookEntry* entries = nullptr;
+	size_t count = 0;
+
+	XBook() {}
+	XBook(const std::string& path) { open(path); }
+	XBook(const XBook&) = delete;
+	XBook& operator=(const XBook&) = delete;
+	~XBook() { close(); }
+
+	bool open(const std::string& path) {
+		close();
+#ifdef XBOOK_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(XBookEntry)) {
+			void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				mapped = p;
+				mappedsize = st.st_size;
+				entries = (const XBookEntry*)p;
+				count = st.st_size / sizeof(XBookEntry);
+			}
+		}
+		::close(fd);
+		return entries != nullptr;
+#else
+		std::ifstream in(path, std::ios::binary);
+		if (!in) return false;
+		XBookEntry e;
+		while (in.read((char*)&e, sizeof(e))) loaded.push_back(e);
+		entries = loaded.data();
+		count = loaded.size();
+		return count > 0;
+#endif
+	}
+
+	void close() {
+#ifdef XBOOK_MMAP
+		if (mapped) munmap(mapped, mappedsize);
+		mapped = nullptr;
+		mappedsize = 0;
+#endif
+		loaded.clear();
+		entries = nullptr;
+		count = 0;
+	}
+
+	// Records for the position, found by binary search
+	std::pair<const XBookEntry*, const XBookEntry*> find(uint64_t key) {
+		XBookEntry probe;
+		probe.key = key;
+		return std::equal_range(entries, entries + count, probe);
+	}
+
+	// Picks one of the book moves for game with probability proportional to its weight. Moves that are not legal here (a hash collision
+	// or a book built with different rules) are skipped. Returns false when the position is not in the book.
+	bool probe(XGame& game, XRandom& rng, std::pair<std::pair<int, int>, std::pair<int, int>>& move) {
+		if (!count) return false;
+		auto range = find(game.hash());
+		uint64_t total = 0;
+		for (auto e = range.first; e != range.second; e++) {
+			XBookEntry entry = *e;
+			if (game.legal(entry.move().first, entry.move().second)) total += entry.weight;
+		}
+		if (total == 0) return false;
+
+		uint64_t r = rng.next() % total;
+		for (auto e = range.first; e != range.second; e++) {
+			XBookEntry entry = *e;
+			if (!game.legal(entry.move().first, entry.move().second)) continue;
+			if (r < entry.weight) {
+				move = entry.move();
+				return true;
+			}
+			r -= entry.weight;
+		}
+		return false;
+	}
+
+	// Merges records with the same position and move, sorts them and writes the file
+	static bool write(const std::string& path, std::vector<XBookEntry> records) {
+		std::sort(records.begin(), records.end(), [](const XBookEntry& a, const XBookEntry& b) {
+			if (a.key != b.key) return a.key < b.key;
+			return std::memcmp(&a.sx, &b.sx, 4) < 0;
+		});
+		std::vector<XBookEntry> merged;
+		for (auto e : records) {
+			if (!merged.empty() && merged.back().key == e.key && std::memcmp(&merged.back().sx, &e.sx, 4) == 0) merged.back().weight += e.weight;
+			else merged.push_back(e);
+		}
+
+		std::ofstream out(path, std::ios::binary);
+		if (!out) return false;
+		out.write((const char*)merged.data(), merged.size() * sizeof(XBookEntry));
+		return (bool)out;
+	}
+
+	private:
+	void* mapped = nullptr;
+	size_t mappedsize = 0;
+	std::vector<XBookEntry> loaded; // Used instead of the mapping where there is no mmap
+};
+
+#endif
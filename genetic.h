@@ -1,357 +1,1935 @@
-#ifndef GENETIC_H
-#define GENETIC_H
-
-#include "xiangqi.h"
-
-#include <set>
-#include <vector>
-#include <algorithm>
-#include <map>
-#include <cfloat>
-#include <climits>
-#include <string>
-#include <cmath>
-
-class XAI {
-	public:
-	// . . . . . . . .  X  X  P  N  B  R  Q  K  C
-	double values[9] = {0, 0, 1, 4, 2, 9, 2, 1000, 4.5};
-	double promotedpawn = 2; // value of a pawn that crosses the center
-	double mob = 1; // mobility of non-king and non-pawns
-	double bndef = 1; // BN defense counter
-    double rdef = 1; // rook defense counter
-	double cdef = 1; // cannon defense counter
-	double qdef = 1; // advisor defense counter
-    double kmob = 1; // King mobility excludes castles
-    double kdef = -1; // If the king is undefended we deduct some points.
-    double chk = 1; // Checks (don't worry about checkmates for now)
-    double ckmt = 1000; // Checkmate value that replaces the check value upon the threat of a mate
-	double movecount = -0.01;
-
-	XAI() {
-		promotedpawn = 2;
-		mob = 1;
-		bndef = 1;
-		rdef = 1;
-		cdef = 1;
-		qdef = 1;
-		kmob = 1;
-		kdef = -1;
-		chk = 1;
-		ckmt = 1000;
-		movecount = -0.01;
-	}
-
-	XAI(double pp, double mo, double bn, double rd, double cd, double qd, double km, double kd, double ch, double ck, double mv) {
-		promotedpawn = pp;
-		mob = mo;
-		bndef = bn;
-		rdef = rd;
-		cdef = cd;
-		qdef = qd;
-		kmob = km;
-		kdef = kd;
-		chk = ch;
-		ckmt = ck;
-		movecount = mv;
-	}
-
-	XAI(const XAI& other) {
-		promotedpawn = other.promotedpawn;
-		mob = other.mob;
-		bndef = other.bndef;
-		rdef = other.rdef;
-		cdef = other.cdef;
-		qdef = other.qdef;
-		kmob = other.kmob;
-		kdef = other.kdef;
-		chk = other.chk;
-		ckmt = other.ckmt;
-		movecount = other.movecount;
-	}
-
-	double getOneSidedScore(XGame game, bool verbose = false) {
-		double material = 0;
-		for (int x = 0; x < 9; x++) {
-			for (int y = 0; y < 10; y++) {
-				XPiece piece = game.get(x, y);
-				if (!piece.isEmpty() && piece.getColor() == game.sidetomove) {
-					if (piece.isPawn()) {
-						if (game.isPoliticallyCorrect(x, y)) material += values[piece.getID()];
-						else material += promotedpawn;
-					}
-					else material += values[piece.getID()];
-				}
-			}
-		}
-
-		std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> legals = game.getAllLegalMoves();
-        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> defs = game.getDefenses();
-
-		double mobs = 0;
-		std::map<std::pair<int, int>, int> pmoves;
-		for (auto p : legals) {
-			XPiece piece = game.get(p.first);
-			if (piece.isEmpty() || piece.isPawn() || piece.isKing()) continue;
-			if (pmoves.find(p.first) == pmoves.end()) pmoves.insert({p.first, 0});
-            (*(pmoves.find(p.first))).second++;
-		}
-
-		int kmobs = 0;
-        for (auto p : legals) {
-            XPiece source = game.get(p.first);
-            if (source.isKing() && abs(p.second.second) != 2) kmobs++;
-        }
-
-		for (auto p : pmoves) mobs += std::sqrt((double)(p.second));
-        
-        int bndefs = 0;
-        int rdefs = 0;
-		int cdefs = 0;
-		int qdefs = 0;
-        int kdefcnt = 0;
-        for (auto p : defs) {
-            XPiece source = game.get(p.second);
-            if (source.isBishop() || source.isKnight()) bndefs++;
-            if (source.isRook()) rdefs++;
-			if (source.isCannon()) cdefs++;
-			if (source.isAdvisor()) qdefs++;
-            if (source.isKing()) kdefcnt++;
-        }
-
-		int kdefs = 0;
-        
-        int you = (game.sidetomove) ? (1<<0) : (1<<1);
-        
-        if (kdefcnt == 0) {
-            for (auto p : game.getAllPieces(you | (1<<7))) {
-                int dx[8] = {00, 01, 01, 01, 00, -1, -1, -1};
-                int dy[8] = {01, 01, 00, -1, -1, -1, 00, 01};
-                for (int i = 0; i < 8; i++) {
-                    for (int k = 1; k < 12; k++) {
-                        std::pair<int, int> des = {p.file() + dx[i] * k, p.rank() + dy[i] * k};
-                        if (!game.inBounds(des)) break;
-                        XPiece x = game.board[des.first][des.second];
-                        if (!x.isEmpty()) break;
-                        kdefs++;
-                    }
-                }
-            }
-        }
-
-		XGame game2(game);
-		game2.sidetomove = !game.sidetomove;
-		int checks = (game2.noChecks()) ? 0 : 1;
-		if (game2.checkmate()) checks = ckmt;
-
-		int movecnt = game.halfmoveclock;
-
-		return material + mobs * mob + kmobs * kmob + bndefs * bndef + rdefs * rdef + cdefs * cdef + qdefs * qdef + kdefs * kdef + checks * chk - movecnt * movecount;
-	}
-
-	double getScore(XGame game, bool verbose = false) {
-		double res = getOneSidedScore(game, verbose);
-		XGame game2(game);
-		game2.sidetomove = !game.sidetomove;
-		return res - getOneSidedScore(game2, verbose);
-	}
-
-	std::pair<std::pair<int, int>, std::pair<int, int>> chosenmove = {{0, 0}, {0, 0}};
-
-    int leafcount = 0;
-
-    double abprune(XGame game, int remlayers, double alpha, double beta, bool isMaximizing) { // remlayers must start (outermost call) at an even number
-        if (remlayers <= 0) {
-            leafcount++;
-            return getScore(game);
-        }
-
-        if (isMaximizing) {
-            double res = -1 * DBL_MAX;
-            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> legals = game.getAllLegalMoves();
-            std::random_shuffle(legals.begin(), legals.end());
-            for (auto p : legals) {
-                XGame game2(game);
-                game2.execute(p.first, p.second);
-
-                game2.sidetomove = !game2.sidetomove;
-                double value = abprune(game2, remlayers - 1, alpha, beta, false);
-                if (value > res) {
-                    chosenmove = p;
-                    res = value;
-                }
-                if (value == res && rand() % 2 == 0) {
-                    chosenmove = p;
-                    res = value;
-                }
-                alpha = std::max(alpha, res);
-                if (beta <= alpha) break;
-            }
-
-            return res;
-            
-        }
-
-        else {
-            double res = DBL_MAX;
-            std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> legals = game.getAllLegalMoves();
-            std::random_shuffle(legals.begin(), legals.end());
-            for (auto p : legals) {
-                XGame game2(game);
-                game2.execute(p.first, p.second);
-                game2.sidetomove = !game2.sidetomove;
-
-                double value = abprune(game2, remlayers - 1, alpha, beta, true);
-                if (value < res) {
-                    res = value;
-                    // chosenmove = p;
-                }
-                if (value == res && rand() % 2 == 0) {
-                    // chosenmove = p;
-                    res = value;
-                }
-                beta = std::min(beta, res);
-                if (beta <= alpha) break;
-            }
-            return res;
-        }
-        return -1;
-
-
-    }
-
-	std::pair<std::pair<int, int>, std::pair<int, int>> pick(XGame game, bool verbose = false) {
-	    // return pickdepth2(game, false);
-
-        leafcount = 0;
-        chosenmove = game.getAllLegalMoves()[0];
-        abprune(game, 2, -1 * DBL_MAX, DBL_MAX, true);
-        if (verbose) std::cout << leafcount << " LEAF NODES CHECKED\n";
-        return chosenmove;
-	}
-    
-    // mob / bndef / rdef / cdef / qdef / kmob / kdef / chk / ckmt / movecount
-
-	std::string toString() {
-        std::string res = "PP " + std::to_string(promotedpawn) + " MOB " + std::to_string(mob) + " BN " + std::to_string(bndef) + " RDEF " + std::to_string(rdef) + " CDEF " + std::to_string(cdef);
-        res = res + " QDEF " + std::to_string(qdef) + " KMOB " + std::to_string(kmob) + " KDEF " + std::to_string(kdef);
-        res = res + " CHK " + std::to_string(chk) + " CKMT " + std::to_string(ckmt) + " MCNT " + std::to_string(movecount);
-        return res;
-    }
-};
-
-namespace Genetic {
-    
-// Play with a1 white and a2 black
-int test(XAI a1, XAI a2, bool verbose = false, int games = 1) {
-	int res = 0;
-	for (int i = 0; i < games; i++) {
-    XGame game;
-    
-    while (true) { // a1 white a2 black
-        auto move = game.sidetomove ? (a1.pick(game)) : (a2.pick(game));
-        game.execute(move.first, move.second);
-        game.sidetomove = !game.sidetomove;
-        
-        if (verbose) std::cout << game.toString() << "\n";
-            
-        if (game.checkmate()) {
-            if (verbose) std::cout << game.toString() << "\n";
-            if (verbose) std::cout << ( game.sidetomove ? "BLACK" : "WHITE" ) << " WINS\n";
-            res += game.sidetomove ? (-2) : (2);
-			break;
-        }
-        
-        if (game.stalemate()) {
-            if (verbose) std::cout << game.toString() << "\n";
-            if (verbose) std::cout << "STALEMATE/DRAW\n";
-            res += game.sidetomove ? (-1) : 1;
-			break;
-        }
-
-		// std::cout << game.toString() << "\n";
-    }
-
-	}
-
-	return res;
-}
-
-std::vector<XAI> tournament(std::vector<XAI> ais, bool verbose = false, int gamesperround = 1) {
-    std::random_shuffle(ais.begin(), ais.end());
-    std::vector<XAI> res;
-    for (int i = 0; i < ais.size() - 1; i += 2) {
-        int val = test(ais[i], ais[i + 1], false, gamesperround);
-        if (val > 0) res.push_back(XAI(ais[i]));
-        else if (val < 0) res.push_back(XAI(ais[i + 1]));
-        else {
-            if (rand() % 2 == 0) res.push_back(XAI(ais[i]));
-            else res.push_back(XAI(ais[i + 1]));
-        }
-        if (verbose) std::cout << "X";
-    }
-    if (verbose) std::cout << "\n";
-    return res;
-}
-
-// mob / rbndef / qdef / kmob / kdef / oo / chk / ckmt / movecount
-
-XAI cross(XAI a1, XAI a2) {
-    XAI res(a1);
-	if (rand() % 2 == 0) res.promotedpawn = a2.promotedpawn;
-    if (rand() % 2 == 0) res.mob = a2.mob;
-    if (rand() % 2 == 0) res.bndef = a2.bndef;
-	if (rand() % 2 == 0) res.rdef = a2.rdef;
-	if (rand() % 2 == 0) res.cdef = a2.cdef;
-    if (rand() % 2 == 0) res.qdef = a2.qdef;
-    if (rand() % 2 == 0) res.kmob = a2.kmob;
-    if (rand() % 2 == 0) res.kdef = a2.kdef;
-    if (rand() % 2 == 0) res.chk = a2.chk;
-    if (rand() % 2 == 0) res.ckmt = a2.ckmt;
-    if (rand() % 2 == 0) res.movecount = a2.movecount;
-    return res;
-}
-
-double randf() {
-    return (double)(rand()) / RAND_MAX;
-}
-
-// mob / bndef / rdef / qdef / cdef / kmob / kdef / oo / chk / ckmt / movecount
-
-XAI mutate(XAI ai) {
-    XAI res(ai);
-    int beep = rand() % 128;
-	while (beep > 96) beep = rand() % 128;
-    if (beep == 0) res.mob = randf() * 4 - 2;
-    if (beep == 1) res.bndef = randf() * 4 - 2;
-    if (beep == 2) res.qdef = randf() * 4 - 2;
-	if (beep == 3) res.rdef = randf() * 4 - 2;
-	if (beep == 4) res.cdef = randf() * 4 - 2;
-    if (beep == 5) res.kmob = randf() * 4 - 2;
-    if (beep == 6) res.kdef = randf() * -4 + 2;
-    if (beep == 7) res.chk = randf() * 4 - 2;
-    // if (beep == 7) res.ckmt = randf() * 400;
-    if (beep == 8) res.movecount = (0.5 - randf()) * 0.5;
-	if (beep == 9) res.promotedpawn = randf() * 8 - 4;
-    return res;
-}
-
-XAI randomAI() {
-    XAI res;
-	res.promotedpawn = randf() * 8 - 4;
-    res.mob = randf() * 4 - 2;
-    res.bndef = randf() * 4 - 2;
-	res.rdef = randf() * 4 - 2;
-	res.cdef = randf() * 4 - 2;
-    res.qdef = randf() * 4 - 2;
-    res.kmob = randf() * 4 - 2;
-    res.kdef = randf() * -4 + 2;
-    res.chk = randf() * 4 - 2;
-    // if (beep == 7) res.ckmt = randf() * 400;
-    res.movecount = (0.5 - randf()) * 0.5;
-    return res;
-}
-
-}
-
+#ifndef GENETIC_H
+#define GENETIC_H
+
+#include "xiangqi.h"
+#include "mate.h"
+#include "book.h"
+#include "tablebase.h"
+#include "nnue.h"
+
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <cfloat>
+#include <climits>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <functional>
+#include <future>
+#include <mutex>
+
+// Transposition table shared between all search threads of an engine.
+// Lockless: each slot stores key ^ data next to data, so a slot torn by two threads writing at once reads back as a miss.
+// Scores are integers (see XAI::SCALE), so a whole entry fits in 16 bytes.
+class XTable {
+	public:
+	static const uint8_t EXACT = 1;
+	static const uint8_t LOWER = 2; // Score is a lower bound (failed high)
+	static const uint8_t UPPER = 3; // Score is an upper bound (failed low)
+
+	struct Entry {
+		std::atomic<uint64_t> check{0};
+		std::atomic<uint64_t> data{0}; // src file/rank, des file/rank, depth, flag, score
+	};
+
+	std::vector<Entry> entries;
+	uint64_t mask;
+
+	XTable(int bits = 16) : entries((size_t)1 << bits) {
+		mask = ((uint64_t)1 << bits) - 1;
+	}
+
+	void clear() {
+		for (auto& e : entries) {
+			e.check.store(0, std::memory_order_relaxed);
+			e.data.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	bool probe(uint64_t key, int& score, std::pair<std::pair<int, int>, std::pair<int, int>>& move, int& depth, uint8_t& flag) {
+		Entry& e = entries[key & mask];
+		uint64_t data = e.data.load(std::memory_order_relaxed);
+		if ((e.check.load(std::memory_order_relaxed) ^ data) != key || data == 0) return false;
+
+		int sx = data & 15, sy = (data >> 4) & 15, dx = (data >> 8) & 15, dy = (data >> 12) & 15;
+		move = {{sx, sy}, {dx - sx, dy - sy}};
+		depth = (data >> 16) & 255;
+		flag = (data >> 24) & 255;
+		score = (int32_t)(uint32_t)(data >> 32);
+		return true;
+	}
+
+	void store(uint64_t key, int score, std::pair<std::pair<int, int>, std::pair<int, int>> move, int depth, uint8_t flag) {
+		Entry& e = entries[key & mask];
+		uint64_t olddata = e.data.load(std::memory_order_relaxed);
+		bool samekey = (e.check.load(std::memory_order_relaxed) ^ olddata) == key;
+		if (samekey && (int)((olddata >> 16) & 255) > depth) return; // Keep the deeper result for the same position
+
+		uint64_t data = (uint64_t)(move.first.first & 15) | ((uint64_t)(move.first.second & 15) << 4);
+		data |= ((uint64_t)((move.first.first + move.second.first) & 15) << 8) | ((uint64_t)((move.first.second + move.second.second) & 15) << 12);
+		data |= ((uint64_t)(depth & 255) << 16) | ((uint64_t)flag << 24) | ((uint64_t)(uint32_t)score << 32);
+		e.data.store(data, std::memory_order_relaxed);
+		e.check.store(key ^ data, std::memory_order_relaxed);
+	}
+};
+
+// Counters for one pick(). Helper threads' counters are added into the main thread's before pick() returns.
+struct XSearchStats {
+	struct Iteration {
+		int depth;
+		long long nodes;
+		double ms;
+		int score;
+	};
+
+	long long nodes = 0; // abprune calls, leaves included
+	long long qnodes = 0; // quiesce calls
+	long long evals = 0; // getScore calls
+	long long expanded = 0; // Interior nodes whose moves were searched
+	long long children = 0; // Moves searched at those nodes
+	long long cutoffs = 0;
+	long long firstcutoffs = 0; // Beta cutoffs on the first move searched
+	long long ttprobes = 0;
+	long long tthits = 0;
+	long long ttstores = 0;
+	long long tbhits = 0; // Nodes scored by a tablebase
+	long long lazymaterial = 0; // Evals that stopped after material
+	long long lazyboard = 0; // Evals that stopped before the check tier
+	long long evalprobes = 0; // Eval cache lookups
+	long long evalhits = 0;
+	double ms = 0;
+	std::vector<Iteration> iterations;
+
+	void add(const XSearchStats& other) {
+		nodes += other.nodes;
+		qnodes += other.qnodes;
+		evals += other.evals;
+		expanded += other.expanded;
+		children += other.children;
+		cutoffs += other.cutoffs;
+		firstcutoffs += other.firstcutoffs;
+		ttprobes += other.ttprobes;
+		tthits += other.tthits;
+		ttstores += other.ttstores;
+		tbhits += other.tbhits;
+		lazymaterial += other.lazymaterial;
+		lazyboard += other.lazyboard;
+		evalprobes += other.evalprobes;
+		evalhits += other.evalhits;
+	}
+
+	double nps() { return (ms > 0) ? (nodes + qnodes) * 1000.0 / ms : 0; }
+	double evalHitRate() { return evalprobes ? (double)evalhits / evalprobes : 0; }
+	double firstCutoffRate() { return cutoffs ? (double)firstcutoffs / cutoffs : 0; }
+	double branching() { return expanded ? (double)children / expanded : 0; }
+
+	std::string toJSON(std::string move = "") {
+		std::ostringstream out;
+		out << "{\"move\":\"" << move << "\",\"nodes\":" << nodes << ",\"qnodes\":" << qnodes << ",\"evals\":" << evals;
+		out << ",\"nps\":" << (long long)nps() << ",\"cutoffs\":" << cutoffs << ",\"firstcutoffrate\":" << firstCutoffRate();
+		out << ",\"ttprobes\":" << ttprobes << ",\"tthits\":" << tthits << ",\"ttstores\":" << ttstores << ",\"tbhits\":" << tbhits;
+		out << ",\"lazymaterial\":" << lazymaterial << ",\"lazyboard\":" << lazyboard;
+		out << ",\"evalprobes\":" << evalprobes << ",\"evalhits\":" << evalhits << ",\"evalhitrate\":" << evalHitRate();
+		out << ",\"branching\":" << branching() << ",\"ms\":" << ms << ",\"iterations\":[";
+		for (int i = 0; i < (int)iterations.size(); i++) {
+			if (i) out << ",";
+			out << "{\"depth\":" << iterations[i].depth << ",\"nodes\":" << iterations[i].nodes << ",\"ms\":" << iterations[i].ms << ",\"score\":" << iterations[i].score << "}";
+		}
+		out << "]}";
+		return out.str();
+	}
+};
+
+// Result of a search, or the best found so far while one is still running
+struct XSearchResult {
+	std::pair<std::pair<int, int>, std::pair<int, int>> move = {{0, 0}, {0, 0}};
+	int score = 0; // In eval units, see XAI::SCALE
+	int depth = 0; // Last completed iteration
+	std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pv;
+	XSearchStats stats;
+};
+
+struct XSearchLimits {
+	int depth = 0; // 0 uses the engine's searchdepth
+	long long nodes = 0; // 0 is unlimited
+	double movetime = 0; // Milliseconds, 0 is unlimited
+	std::function<void(const XSearchResult&)> onprogress; // Called from the search thread after every completed iteration
+};
+
+// Handle to a search started with XAI::startSearch. Copies refer to the same search.
+class XSearchHandle {
+	public:
+	struct State {
+		std::atomic<bool> stop{false};
+		std::mutex lock;
+		XSearchResult best;
+	};
+
+	std::shared_ptr<State> state;
+	std::shared_future<XSearchResult> result;
+
+	// Asks the search to finish. The result is the best move of the last completed iteration.
+	void stop() { state->stop = true; }
+
+	XSearchResult bestSoFar() {
+		std::lock_guard<std::mutex> guard(state->lock);
+		return state->best;
+	}
+
+	bool done() { return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+	XSearchResult get() { return result.get(); }
+};
+
+// A side's clock. All times are in milliseconds. Without remaining or movetime the engine searches to a fixed depth. A clock that
+// has run out still counts as timed (see XAI::onClock), and every move then plays its first completed iteration.
+struct XClock {
+	double remaining = 0; // Time left on the clock
+	double increment = 0; // Added after every move
+	int movestogo = 0; // Moves until the next time control, 0 means the rest of the game
+	double movetime = 0; // Fixed time per move, overrides the above
+
+	bool timed() { return remaining > 0 || movetime > 0; }
+};
+
+// Sizes one move's search from the clock. The optimum budget is what the move should normally take; it is stretched when the best
+// move keeps changing or the score drops, and cut when the best move has been stable for a few iterations. The maximum is a hard stop
+// the search checks while it runs.
+class XTimeManager {
+	public:
+	double overhead = 20; // Kept in reserve per move for everything outside the search
+	int expectedmoves = 30; // Moves the remaining time is spread over in sudden death
+
+	double optimum = 0;
+	double maximum = 0;
+	std::chrono::steady_clock::time_point start;
+
+	int stable = 0; // Iterations in a row with the same best move
+	double factor = 1;
+
+	void begin(XClock clock) {
+		start = std::chrono::steady_clock::now();
+		stable = 0;
+		factor = 1;
+		if (clock.movetime > 0) {
+			optimum = maximum = std::max(1.0, clock.movetime - overhead);
+			return;
+		}
+		double left = std::max(1.0, clock.remaining - overhead);
+		int moves = (clock.movestogo > 0) ? std::min(clock.movestogo, expectedmoves) : expectedmoves;
+		optimum = std::min(left / moves + clock.increment * 0.75, left * 0.5);
+		maximum = std::min(optimum * 4, left * 0.75);
+	}
+
+	double elapsed() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); }
+
+	// After every completed iteration. Returns false if the next one should not be started.
+	bool next(bool bestchanged, double scoredrop, double margin) {
+		stable = bestchanged ? 0 : stable + 1;
+		factor = 1;
+		if (bestchanged) factor *= 1.6;
+		else if (stable >= 3) factor *= 0.6;
+		if (scoredrop > margin) factor *= 1.4;
+		double budget = std::min(optimum * factor, maximum);
+		return elapsed() < budget * 0.5; // The next iteration takes longer than everything so far, so only start it with room left
+	}
+
+	bool hardStop() { return elapsed() >= maximum; }
+};
+
+// Evaluation features of a position: the side to move's count of each term minus the other side's. They do not depend on any
+// weights, so one extraction can be scored by any number of genomes with dot(), and tuning tools can compute them once per position.
+// Features are fixed point with ONE units per count, so scoring is integer arithmetic and gives the same result on every platform.
+struct XFeatures {
+	enum {
+		PAWNS, KNIGHTS, BISHOPS, ROOKS, ADVISORS, KINGS, CANNONS, // Pieces by getID() - 2
+		CROSSED, // Soldiers across the river, on top of their pawn count
+		MOBILITY, // Sum over non-pawn, non-king pieces of the square root of their move count
+		KINGMOBILITY,
+		BNDEFS, RDEFS, CDEFS, QDEFS, // Own horses and elephants, chariots, cannons and advisors touched by enemy pieces
+		KDEFS, // Empty squares on the lines out of the general when no enemy piece touches it
+		CHECKS, // Check given without mate
+		MATES, // Check given with mate
+		COUNT
+	};
+
+	static const int ONE = 1024;
+	int32_t f[COUNT] = {0};
+};
+
+// Feature weights in eval units per count (see XAI::weights)
+struct XWeights {
+	int32_t w[XFeatures::COUNT] = {0};
+};
+
+inline int dot(const XWeights& weights, const XFeatures& features) {
+	int64_t res = 0;
+	for (int i = 0; i < XFeatures::COUNT; i++) res += (int64_t)weights.w[i] * features.f[i];
+	return (int)(res / XFeatures::ONE);
+}
+
+// Square roots of the move counts a piece can reach in feature units, so mobility needs no sqrt per piece. A chariot or cannon tops
+// out at 26 since the move generator lists the downward direction twice. std::sqrt is correctly rounded, so the table is the same
+// everywhere.
+struct XMobilityTable {
+	static const int size = 27;
+	int32_t roots[size];
+
+	XMobilityTable() {
+		for (int i = 0; i < size; i++) roots[i] = (int32_t)std::lround(std::sqrt((double)i) * XFeatures::ONE);
+	}
+
+	static const XMobilityTable& get() {
+		static XMobilityTable table;
+		return table;
+	}
+};
+
+// The features come in three tiers of rising cost, so an evaluator can stop early once the rest cannot matter (see XAI::getScore).
+// Each adds its features into res.
+
+// Material, read off the game's running counts
+inline void materialFeatures(XGame& game, XFeatures& res) {
+	bool stm = game.sidetomove;
+	for (int id = 2; id < 9; id++) res.f[XFeatures::PAWNS + id - 2] += (game.counts[stm][id] - game.counts[!stm][id]) * XFeatures::ONE;
+	res.f[XFeatures::CROSSED] += (game.crossed[stm] - game.crossed[!stm]) * XFeatures::ONE;
+}
+
+// Mobility, defenses and open lines in one pass over the board, without copying the game or generating legal moves. Mobility counts
+// the moves getAllLegalMoves tries for each piece, minus the test for leaving the own general in check; only the general's own moves
+// are checked for safety. Defenses count the pieces each enemy piece touches the way getDefenses scans them. Both follow those
+// generators' quirks exactly (chariots, cannons and generals list the downward direction twice, horse legs are only blocked by their
+// own side and so on).
+inline void boardFeatures(XGame& game, XFeatures& res) {
+	const int32_t* roots = XMobilityTable::get().roots;
+	int32_t side[2][XFeatures::COUNT] = {{0}}; // Black, red
+	int kdefcnt[2] = {0, 0};
+	int gx[2] = {-1, -1};
+	int gy[2] = {-1, -1};
+
+	auto inside = [](int x, int y) { return x >= 0 && y >= 0 && x < 9 && y < 10; };
+
+	// Counts the piece on (x, y) as touched by the enemy
+	auto defended = [&](int x, int y) {
+		XPiece& piece = game.board[x][y];
+		int s = piece.getColor();
+		if (piece.isBishop() || piece.isKnight()) side[s][XFeatures::BNDEFS] += XFeatures::ONE;
+		if (piece.isRook()) side[s][XFeatures::RDEFS] += XFeatures::ONE;
+		if (piece.isCannon()) side[s][XFeatures::CDEFS] += XFeatures::ONE;
+		if (piece.isAdvisor()) side[s][XFeatures::QDEFS] += XFeatures::ONE;
+		if (piece.isKing()) kdefcnt[s]++;
+	};
+
+	for (int x = 0; x < 9; x++) {
+		for (int y = 0; y < 10; y++) {
+			XPiece& piece = game.board[x][y];
+			if (piece.isEmpty()) continue;
+			bool red = piece.getColor();
+			int32_t* t = side[red];
+			auto ownside = [red](int y) { return red ? (y < 5) : (y >= 5); };
+			auto palace = [red](int x, int y) { return (x >= 3) && (x <= 5) && (red ? (y < 3) : (y > 6)); };
+			auto enemypalace = [red](int x, int y) { return (x >= 3) && (x <= 5) && (red ? (y > 6) : (y < 3)); };
+			auto free = [&game, red](int x, int y) { return game.board[x][y].isEmpty() || game.board[x][y].getColor() != red; }; // Empty or enemy
+			auto enemy = [&game, red, inside](int x, int y) { return inside(x, y) && !game.board[x][y].isEmpty() && game.board[x][y].getColor() != red; };
+			int moves = 0;
+
+			if (piece.isPawn()) {
+				int dx[3] = {01, 00, -1};
+				int dy[3] = {00, 01, 00};
+				for (int i = 0; i < 3; i++) {
+					if (enemy(x + dx[i], y + dy[i])) defended(x + dx[i], y + dy[i]);
+				}
+				continue;
+			}
+
+			if (piece.isRook() || piece.isCannon()) {
+				int mx[4] = {01, 00, -1, 00}; // The move generator's directions
+				int my[4] = {00, -1, 00, -1};
+				for (int i = 0; i < 4; i++) {
+					int screens = 0;
+					for (int k = 1; inside(x + mx[i] * k, y + my[i] * k); k++) {
+						XPiece& other = game.board[x + mx[i] * k][y + my[i] * k];
+						if (other.isEmpty()) {
+							if (screens == 0) moves++;
+							continue;
+						}
+						if (piece.isRook() || screens == 1) {
+							if (other.getColor() != red) moves++;
+							break;
+						}
+						screens++;
+					}
+				}
+
+				int lx[4] = {00, 01, 00, -1}; // getDefenses' directions
+				int ly[4] = {01, 00, -1, 00};
+				for (int i = 0; i < 4; i++) {
+					if (!enemy(x + lx[i], y + ly[i])) continue;
+					if (piece.isRook()) defended(x + lx[i], y + ly[i]);
+					else {
+						for (int k = 2; inside(x + lx[i] * k, y + ly[i] * k); k++) {
+							defended(x + lx[i], y + ly[i]);
+							if (!game.board[x + lx[i] * k][y + ly[i] * k].isEmpty()) break;
+						}
+					}
+				}
+			}
+
+			if (piece.isKnight()) {
+				int dx[8] = {02, 01, -1, -2, -2, -1, 01, 02};
+				int dy[8] = {01, 02, 02, 01, -1, -2, -2, -1};
+				for (int i = 0; i < 8; i++) {
+					int bx = (abs(dx[i]) == 2) ? dx[i] / 2 : 0;
+					int by = (abs(dy[i]) == 2) ? dy[i] / 2 : 0;
+					if (!inside(x + dx[i], y + dy[i])) continue;
+					if (free(x + bx, y + by)) moves++;
+					if (game.board[x + bx][y + by].isEmpty() && enemy(x + dx[i], y + dy[i])) defended(x + dx[i], y + dy[i]);
+				}
+			}
+
+			if (piece.isBishop()) {
+				int dx[4] = {02, 02, -2, -2};
+				int dy[4] = {02, -2, 02, -2};
+				for (int i = 0; i < 4; i++) {
+					if (!inside(x + dx[i], y + dy[i])) continue;
+					if (ownside(y) && ownside(y + dy[i]) && game.board[x + dx[i] / 2][y + dy[i] / 2].isEmpty() && free(x + dx[i], y + dy[i])) moves++;
+					if (!ownside(y + dy[i]) && enemy(x + dx[i], y + dy[i])) defended(x + dx[i], y + dy[i]);
+				}
+			}
+
+			if (piece.isAdvisor()) {
+				int dx[4] = {01, 01, -1, -1};
+				int dy[4] = {01, -1, 01, -1};
+				for (int i = 0; i < 4; i++) {
+					if (!inside(x + dx[i], y + dy[i])) continue;
+					if (palace(x, y) && palace(x + dx[i], y + dy[i]) && free(x + dx[i], y + dy[i])) moves++;
+					if (enemypalace(x + dx[i], y + dy[i]) && enemy(x + dx[i], y + dy[i])) defended(x + dx[i], y + dy[i]);
+				}
+			}
+
+			if (piece.isKing()) {
+				gx[red] = x;
+				gy[red] = y;
+				int mx[4] = {01, 00, -1, 00};
+				int my[4] = {00, -1, 00, -1};
+				int lx[4] = {00, 01, 00, -1};
+				int ly[4] = {01, 00, 01, 00};
+				// A step is safe if nothing attacks the square with the general lifted off its own, and it does not face the other general
+				auto safe = [&](int nx, int ny) {
+					XPiece self = game.board[x][y];
+					game.board[x][y] = XPiece();
+					bool res = game.attackersTo(nx, ny, !red).empty();
+					game.board[x][y] = self;
+					for (int k = ny + (red ? 1 : -1); res && k >= 0 && k < 10; k += (red ? 1 : -1)) {
+						if (game.board[nx][k].isEmpty()) continue;
+						if (game.board[nx][k].isKing()) res = false;
+						break;
+					}
+					return res;
+				};
+				for (int i = 0; i < 4; i++) {
+					if (inside(x + mx[i], y + my[i]) && palace(x, y) && palace(x + mx[i], y + my[i]) && free(x + mx[i], y + my[i]) && safe(x + mx[i], y + my[i])) t[XFeatures::KINGMOBILITY] += XFeatures::ONE;
+					if (enemypalace(x + lx[i], y + ly[i]) && enemy(x + lx[i], y + ly[i])) defended(x + lx[i], y + ly[i]);
+				}
+				continue;
+			}
+
+			t[XFeatures::MOBILITY] += roots[moves];
+		}
+	}
+
+	// Open lines around a general nobody touches
+	for (int s = 0; s < 2; s++) {
+		if (kdefcnt[s] || gx[s] < 0) continue;
+		int dx[8] = {00, 01, 01, 01, 00, -1, -1, -1};
+		int dy[8] = {01, 01, 00, -1, -1, -1, 00, 01};
+		for (int i = 0; i < 8; i++) {
+			for (int k = 1; inside(gx[s] + dx[i] * k, gy[s] + dy[i] * k); k++) {
+				if (!game.board[gx[s] + dx[i] * k][gy[s] + dy[i] * k].isEmpty()) break;
+				side[s][XFeatures::KDEFS] += XFeatures::ONE;
+			}
+		}
+	}
+
+	bool stm = game.sidetomove;
+	for (int i = 0; i < XFeatures::COUNT; i++) res.f[i] += side[stm][i] - side[!stm][i];
+}
+
+// Checks given by each side. The move generator only runs when there is a check, to tell a mate apart.
+inline void checkFeatures(XGame& game, XFeatures& res) {
+	bool stm = game.sidetomove;
+	for (int s = 0; s < 2; s++) {
+		game.sidetomove = !s;
+		if (!game.noChecks()) res.f[game.hasLegalMoves() ? XFeatures::CHECKS : XFeatures::MATES] += (s == stm) ? XFeatures::ONE : -XFeatures::ONE;
+	}
+	game.sidetomove = stm;
+}
+
+inline XFeatures extractFeatures(XGame& game) {
+	XFeatures res;
+	materialFeatures(game, res);
+	boardFeatures(game, res);
+	checkFeatures(game, res);
+	return res;
+}
+
+class XAI {
+	public:
+	// . . . . . . . .  X  X  P  N  B  R  Q  K  C
+	double values[9] = {0, 0, 1, 4, 2, 9, 2, 1000, 4.5};
+	double promotedpawn = 2; // value of a pawn that crosses the center
+	double mob = 1; // mobility of non-king and non-pawns
+	double bndef = 1; // BN defense counter
+    double rdef = 1; // rook defense counter
+	double cdef = 1; // cannon defense counter
+	double qdef = 1; // advisor defense counter
+    double kmob = 1; // King mobility excludes castles
+    double kdef = -1; // If the king is undefended we deduct some points.
+    double chk = 1; // Checks (don't worry about checkmates for now)
+    double ckmt = 1000; // Checkmate value that replaces the check value upon the threat of a mate
+	double movecount = -0.01;
+
+	// Piece-square bonuses by piece ID and square (9 * rank + file) from red's side, mirrored for black. Added to the eval on top of
+	// values[], so all zeros leaves it unchanged.
+	double pst[9][90] = {{0}};
+
+	XAI() {
+		promotedpawn = 2;
+		mob = 1;
+		bndef = 1;
+		rdef = 1;
+		cdef = 1;
+		qdef = 1;
+		kmob = 1;
+		kdef = -1;
+		chk = 1;
+		ckmt = 1000;
+		movecount = -0.01;
+		quantize();
+	}
+
+	XAI(double pp, double mo, double bn, double rd, double cd, double qd, double km, double kd, double ch, double ck, double mv) {
+		promotedpawn = pp;
+		mob = mo;
+		bndef = bn;
+		rdef = rd;
+		cdef = cd;
+		qdef = qd;
+		kmob = km;
+		kdef = kd;
+		chk = ch;
+		ckmt = ck;
+		movecount = mv;
+		quantize();
+	}
+
+	// The same with the piece-square tables, written the way pieceSquareString() writes them (the part of toString() after PST)
+	XAI(double pp, double mo, double bn, double rd, double cd, double qd, double km, double kd, double ch, double ck, double mv, const std::string& table)
+		: XAI(pp, mo, bn, rd, cd, qd, km, kd, ch, ck, mv) {
+		readPieceSquare(table);
+		quantize();
+	}
+
+	XAI(const XAI& other) {
+		copySettings(other);
+		statslog = other.statslog;
+		maxnodes = other.maxnodes;
+		onprogress = other.onprogress;
+		std::memcpy(iterscores, other.iterscores, sizeof(iterscores));
+		std::memcpy(iterscored, other.iterscored, sizeof(iterscored));
+	}
+
+	// Takes over other's genome and search settings. The copy constructor starts with it, and pick() brings the Lazy SMP helpers up
+	// to date with it.
+	void copySettings(const XAI& other) {
+		promotedpawn = other.promotedpawn;
+		mob = other.mob;
+		bndef = other.bndef;
+		rdef = other.rdef;
+		cdef = other.cdef;
+		qdef = other.qdef;
+		kmob = other.kmob;
+		kdef = other.kdef;
+		chk = other.chk;
+		ckmt = other.ckmt;
+		movecount = other.movecount;
+		std::memcpy(pst, other.pst, sizeof(pst));
+
+		pruning = other.pruning;
+		qlayers = other.qlayers;
+		probcutdepth = other.probcutdepth;
+		lazy = other.lazy;
+		lmrdepth = other.lmrdepth;
+		lmrmoves = other.lmrmoves;
+		searchdepth = other.searchdepth;
+		threads = other.threads;
+		ttbits = other.ttbits;
+		evalbits = other.evalbits;
+		rng = other.rng;
+		ponder = other.ponder;
+		multipv = other.multipv;
+		matenodes = other.matenodes;
+		reuse = other.reuse;
+		book = other.book;
+		timecontrol = other.timecontrol;
+		clock = other.clock;
+		tablebases = other.tablebases;
+		network = other.network;
+		quantize();
+	}
+
+	// Scores are integers in eval units, SCALE per pawn (values[2]). The genome stays in doubles and quantize() rounds it to eval units
+	// once, so all eval and search arithmetic is on integers and gives the same result on every platform.
+	static const int SCALE = 1000;
+	static const int MATESCORE = 100000000; // Mated in n plies scores -(MATESCORE - n), tablebase results also count their distance
+	static const int MATEBOUND = MATESCORE - 1000; // Scores beyond this are proven results
+	static const int MAXSCORE = 1 << 30; // Window bound beyond every score
+
+	static int fixed(double x) { return (int)std::lround(x * SCALE); }
+
+	// The weights matching extractFeatures, in the same layout
+	XWeights weights() {
+		XWeights w;
+		for (int id = 2; id < 9; id++) w.w[XFeatures::PAWNS + id - 2] = fixed(values[id]);
+		w.w[XFeatures::CROSSED] = fixed(promotedpawn) - fixed(values[2]);
+		w.w[XFeatures::MOBILITY] = fixed(mob);
+		w.w[XFeatures::KINGMOBILITY] = fixed(kmob);
+		w.w[XFeatures::BNDEFS] = fixed(bndef);
+		w.w[XFeatures::RDEFS] = fixed(rdef);
+		w.w[XFeatures::CDEFS] = fixed(cdef);
+		w.w[XFeatures::QDEFS] = fixed(qdef);
+		w.w[XFeatures::KDEFS] = fixed(kdef);
+		w.w[XFeatures::CHECKS] = fixed(chk);
+		w.w[XFeatures::MATES] = fixed(chk * ckmt);
+		return w;
+	}
+
+	// The genome in eval units, as the eval and the search use it. Refreshed by quantize(), which the constructors and every search
+	// call; anyone changing the genome and then calling getScore outside a search calls it too.
+	XWeights weightsfixed;
+	int valuesfixed[9] = {0};
+	int pstfixed[9][90] = {{0}}; // Installed in the root game when a search starts (see abprune)
+	int boardmargin = 0; // Lazy eval margins, see getScore
+	int checkmargin = 0;
+
+	void quantize() {
+		weightsfixed = weights();
+		for (int id = 0; id < 9; id++) valuesfixed[id] = fixed(values[id]);
+		for (int id = 0; id < 9; id++) {
+			for (int sq = 0; sq < 90; sq++) pstfixed[id][sq] = fixed(pst[id][sq]);
+		}
+		boardmargin = lazyMargin(weightsfixed);
+		checkmargin = 2 * std::abs(weightsfixed.w[XFeatures::CHECKS]); // A check each way
+	}
+
+	// The move count term is the same for both sides and cancels out
+	int getScore(XGame& game, bool verbose = false) { return getScore(game, -MAXSCORE, MAXSCORE); }
+
+	// Lazy evaluation: the tiers are added one at a time, and once the score so far plus a margin for the remaining tiers stays outside
+	// (alpha, beta) the partial score is returned. The check tier's margin is a bound, but the board tier's is tuned (see lazyMargin),
+	// so a partial score now and then lands on the wrong side of the window; so does one that skipped a checkmate.
+	// exact is cleared when a tier was skipped. acc is the network's accumulator for game, if the caller keeps one.
+	int getScore(XGame& game, int alpha, int beta, bool* exact = nullptr, const XAccumulator* acc = nullptr) {
+		stats.evals++;
+		if (network) {
+			if (exact) *exact = true;
+			return networkScore(game, acc);
+		}
+		if (exact) *exact = false;
+		if (!lazy) {
+			alpha = -MAXSCORE;
+			beta = MAXSCORE;
+		}
+		const XWeights& w = weightsfixed;
+		XFeatures f;
+		materialFeatures(game, f);
+		int res = dot(w, f) + pieceSquare(game);
+		int margin = boardmargin + checkmargin;
+		if (res + margin <= alpha || res - margin >= beta) {
+			stats.lazymaterial++;
+			return res;
+		}
+
+		boardFeatures(game, f);
+		res = dot(w, f) + pieceSquare(game);
+		if (res + checkmargin <= alpha || res - checkmargin >= beta) {
+			stats.lazyboard++;
+			return res;
+		}
+
+		checkFeatures(game, f);
+		if (exact) *exact = true;
+		return dot(w, f) + pieceSquare(game);
+	}
+
+	// getScore through the thread's eval cache, for the search's position at ply. Only the search uses it, since evalkey is taken when
+	// the search starts (see abprune).
+	int cachedScore(XGame& game, int alpha, int beta, int ply) {
+		const XAccumulator* acc = (network && ply < (int)arena.accs.size()) ? &arena.accs[ply] : nullptr;
+		if (arena.evals.empty()) return getScore(game, alpha, beta, nullptr, acc);
+		uint64_t key = game.hash() ^ evalkey;
+		Arena::EvalEntry& entry = arena.evals[key & (arena.evals.size() - 1)];
+		stats.evalprobes++;
+		if (entry.key == key) {
+			stats.evalhits++;
+			return entry.score;
+		}
+		bool exact;
+		int res = getScore(game, alpha, beta, &exact, acc);
+		if (exact) { // Lazy partial scores only hold for their window
+			entry.key = key;
+			entry.score = res;
+		}
+		return res;
+	}
+
+	// Hash of everything getScore depends on besides the position
+	uint64_t fingerprint() {
+		uint64_t res = 0;
+		auto mix = [&res](uint64_t bits) {
+			res ^= bits;
+			res = Zobrist::next(res);
+		};
+		XWeights w = weights();
+		for (int i = 0; i < XFeatures::COUNT; i++) mix((uint32_t)w.w[i]);
+		for (int id = 2; id < 9; id++) {
+			for (int sq = 0; sq < 90; sq++) mix((uint32_t)fixed(pst[id][sq]));
+		}
+		if (network) mix(network->id);
+		return res;
+	}
+
+	// Neural evaluator, shared between engines. While set it replaces the weighted features in getScore, while the pruning margins
+	// still go by getMaterial.
+	std::shared_ptr<XNetwork> network;
+
+	// Without the search's accumulator the game is summed from scratch
+	int networkScore(XGame& game, const XAccumulator* acc) {
+		if (acc) return acc->evaluate(*network, game.sidetomove);
+		XAccumulator scratch;
+		scratch.refresh(*network, game);
+		return scratch.evaluate(*network, game.sidetomove);
+	}
+
+	// Brings the network's accumulator at ply + 1 up to date with child, reached by move p from the search's position at ply
+	void makeAccumulator(XGame& child, std::pair<std::pair<int, int>, std::pair<int, int>> p, int ply) {
+		if (network) arena.accs[ply + 1].update(*network, arena.accs[ply], child, p);
+	}
+
+	// Side to move's piece-square sum minus the other side's. Games searched by this engine carry the sums; any other game is summed
+	// from scratch.
+	int pieceSquare(XGame& game) {
+		bool stm = game.sidetomove;
+		if (game.pst == pstfixed) return game.psq[stm] - game.psq[!stm];
+		int res = 0;
+		for (int x = 0; x < 9; x++) {
+			for (int y = 0; y < 10; y++) {
+				XPiece piece = game.board[x][y];
+				if (piece.isEmpty()) continue;
+				int v = pstfixed[piece.getID()][XGame::pstSquare(piece.getColor(), x, y)];
+				res += (piece.getColor() == stm) ? v : -v;
+			}
+		}
+		return res;
+	}
+
+	// Material and piece-square estimate from the side to move's perspective (same terms as the material part of getScore).
+	// Read off the game's running sums, so the pruning heuristics below use it as the static estimate.
+	int getMaterial(XGame& game) {
+		bool stm = game.sidetomove;
+		int res = weightsfixed.w[XFeatures::CROSSED] * (game.crossed[stm] - game.crossed[!stm]);
+		for (int id = 2; id < 9; id++) res += valuesfixed[id] * (game.counts[stm][id] - game.counts[!stm][id]);
+		return res + pieceSquare(game);
+	}
+
+	std::pair<std::pair<int, int>, std::pair<int, int>> chosenmove = {{0, 0}, {0, 0}};
+
+    int leafcount = 0;
+
+    XSearchStats stats; // Filled in by pick()
+    std::ostream* statslog = nullptr; // If set, pick() writes stats as one JSON line per move. Copies log to the same stream.
+
+    XRandom rng; // Shuffles moves before ordering so equal moves are tried in a random order
+
+    // Triangular PV table. Row ply holds the best line found from that ply onwards.
+    static constexpr int MAXPLY = 32;
+    std::pair<std::pair<int, int>, std::pair<int, int>> pvtable[MAXPLY][MAXPLY];
+    int pvlength[MAXPLY];
+    std::pair<std::pair<int, int>, std::pair<int, int>> prevpv[MAXPLY]; // PV of the last completed iteration, searched first
+    int prevpvlength = 0;
+    bool followpv = false;
+
+    // Move ordering state. Every search thread has its own copy, aligned so threads do not share cache lines.
+    alignas(64) std::pair<std::pair<int, int>, std::pair<int, int>> killers[MAXPLY][2];
+    alignas(64) int history[2][9][90];
+
+    // Scratch memory of one search thread: a move buffer per ply (abprune and quiesce share the numbering), the move
+    // ordering keys and the eval cache. Sized before the search starts, so no node allocates.
+    // Copies of an XAI get their own arena.
+    struct Arena {
+        std::vector<XMoveList> moves;
+        int keys[XMoveList::capacity];
+
+        // Direct-mapped cache of full evals, keyed by position hash ^ the engine's fingerprint so genomes sharing a process, or a
+        // genome whose weights changed since the last search, never read each other's scores. Kept across pick() calls.
+        struct EvalEntry {
+            uint64_t key = 0;
+            int score = 0;
+        };
+        std::vector<EvalEntry> evals;
+
+        std::vector<XAccumulator> accs; // The network's sums for the position at each ply, only kept with a network
+
+        void reserve(int plies, int evalbits, bool network) {
+            if ((int)moves.size() < plies) moves.resize(plies);
+            if (network && (int)accs.size() < plies) accs.resize(plies);
+            size_t slots = evalbits > 0 ? (size_t)1 << evalbits : 0;
+            if (evals.size() != slots) evals.assign(slots, EvalEntry());
+        }
+    };
+    Arena arena;
+    int evalbits = 14; // log2 of the number of eval cache entries per thread, 0 turns the cache off
+    uint64_t evalkey = 0; // fingerprint() at the start of the current search
+
+    // Shared between the threads of one pick(). A fresh copy of an XAI gets its own table on its first pick().
+    std::shared_ptr<XTable> table;
+    int ttbits = 16; // log2 of the number of table entries
+    std::atomic<bool>* stopflag = nullptr; // Set for helper threads; they bail out as soon as it goes up
+
+    long long maxnodes = 0; // Node limit for one pick(), 0 is unlimited
+    std::function<void(const XSearchResult&)> onprogress; // Called after every completed iteration of the main search
+
+    bool stopped() { return (stopflag && stopflag->load(std::memory_order_relaxed)) || (maxnodes && stats.nodes >= maxnodes) || timeUp(); }
+
+    // Time control. timecontrol is the clock at the start of a game, clock the one running now; pick() charges its own time to it.
+    XClock timecontrol;
+    XClock clock;
+    XTimeManager time;
+    bool timed = false; // This pick() runs on the clock
+
+    // The game is played on a clock, even if it has run out. Engines that search on behalf of this one clear both clocks.
+    bool onClock() { return timecontrol.timed() || clock.timed(); }
+    bool timeout = false;
+    int timechecks = 0;
+
+    // The clock is only read every so often, and never before the first iteration is complete so there is always a move
+    bool timeUp() {
+        if (!timed) return false;
+        if (!timeout && !stats.iterations.empty() && (++timechecks & 63) == 0 && time.hardStop()) timeout = true;
+        return timeout;
+    }
+
+    // Static exchange evaluation - the material the side playing capture p comes out with if both sides keep recapturing on the target
+    // square with their cheapest piece, each free to stop when that is better. Attackers are looked up again on the updated board after
+    // every capture, so pieces lined up behind a capturer and cannon screens that are created or removed along the way are accounted for.
+    // The captures are made on game's board alone, since attackersTo reads nothing else, and taken back before returning.
+    int SEE(XGame& game, std::pair<std::pair<int, int>, std::pair<int, int>> p) {
+        int tx = p.first.first + p.second.first;
+        int ty = p.first.second + p.second.second;
+        int gain[40];
+        std::pair<int, int> from[40]; // Square each capture came from and the piece it took, to undo them
+        XPiece taken[40];
+        int d = 0;
+        gain[0] = valuesfixed[game.get(tx, ty).getID()];
+        bool side = !game.get(p.first).getColor();
+        from[0] = p.first;
+        taken[0] = game.board[tx][ty];
+        game.board[tx][ty] = game.board[p.first.first][p.first.second];
+        game.board[p.first.first][p.first.second] = XPiece();
+
+        while (d < 39) {
+            XPositions attackers = game.attackersTo(tx, ty, side);
+            if (attackers.empty()) break;
+            Position least = attackers[0];
+            for (auto a : attackers) {
+                if (valuesfixed[game.get(a).getID()] < valuesfixed[game.get(least).getID()]) least = a;
+            }
+            d++;
+            gain[d] = valuesfixed[game.get(tx, ty).getID()] - gain[d - 1];
+            from[d] = least.pos();
+            taken[d] = game.board[tx][ty];
+            game.board[tx][ty] = game.board[least.file()][least.rank()];
+            game.board[least.file()][least.rank()] = XPiece();
+            side = !side;
+        }
+
+        for (int i = d; i >= 0; i--) {
+            game.board[from[i].first][from[i].second] = game.board[tx][ty];
+            game.board[tx][ty] = taken[i];
+        }
+
+        while (d > 0) {
+            gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+            d--;
+        }
+        return gain[0];
+    }
+
+    // TT move, then captures that do not lose material by most valuable victim / least valuable attacker, then killers, then history,
+    // then losing captures.
+    // Stable so the shuffle still breaks ties between equal moves.
+    void orderMoves(XGame& game, XMoveList& legals, std::pair<std::pair<int, int>, std::pair<int, int>> ttmove, int ply) {
+        int* keys = arena.keys;
+        for (int i = 0; i < legals.size(); i++) {
+            auto p = legals[i];
+            XPiece piece = game.get(p.first);
+            XPiece victim = game.get(p.first.first + p.second.first, p.first.second + p.second.second);
+            int key;
+            if (p == ttmove) key = INT_MAX;
+            else if (!victim.isEmpty()) {
+                int see = SEE(game, p);
+                // Victims are worth at most a general, 1000 pawns, so good captures stay within 1e9 + 1e8 and above the killers
+                key = (see >= 0) ? 1000000000 + 100 * valuesfixed[victim.getID()] - valuesfixed[piece.getID()] : -1000000000 + see; // Losing captures go last
+            }
+            else if (p == killers[ply][0]) key = 100000001;
+            else if (p == killers[ply][1]) key = 100000000;
+            else key = history[piece.getColor()][piece.getID()][9 * (p.first.second + p.second.second) + p.first.first + p.second.first];
+            keys[i] = key;
+        }
+
+        // Insertion sort - the lists are short and std::stable_sort wants a temporary buffer from the heap
+        for (int i = 1; i < legals.size(); i++) {
+            int key = keys[i];
+            auto p = legals[i];
+            int j = i - 1;
+            for (; j >= 0 && keys[j] < key; j--) {
+                keys[j + 1] = keys[j];
+                legals[j + 1] = legals[j];
+            }
+            keys[j + 1] = key;
+            legals[j + 1] = p;
+        }
+    }
+
+    void clearOrdering() {
+        for (int i = 0; i < MAXPLY; i++) killers[i][0] = killers[i][1] = {{-1, -1}, {0, 0}};
+        std::memset(history, 0, sizeof(history));
+    }
+
+    // Hands the table and the move ordering to an engine searching on behalf of this one (ponder, startSearch), so its pick() reuses
+    // them like ours would instead of clearing the shared table
+    void shareState(XAI& engine) {
+        engine.table = table;
+        engine.warm = warm;
+        std::memcpy(engine.history, history, sizeof(history));
+        for (int i = 0; i < MAXPLY; i++) {
+            for (int k = 0; k < 2; k++) engine.killers[i][k] = killers[i][k];
+        }
+    }
+
+    // Shallow depth pruning. All margins are in units of values[] so they scale with the material table.
+    bool pruning = true;
+    int qlayers = 4; // Maximum depth of the capture-only search used by razoring
+    int probcutdepth = 4; // ProbCut only kicks in at this many remaining layers or more
+
+    int lmrdepth = 3; // Late move reductions need at least this many remaining layers
+    int lmrmoves = 3; // and this many moves searched at the node already
+
+    int futilityMargin(int remlayers) { return remlayers * valuesfixed[5]; } // A chariot per remaining layer
+    int razorMargin(int remlayers) { return futilityMargin(remlayers) + valuesfixed[3]; }
+    int probcutMargin() { return valuesfixed[8]; }
+
+    bool lazy = true; // Lazy evaluation at the leaves (see getScore)
+
+    // How far the board tier may move the score before a lazy exit after material: each of its weights times a count the feature
+    // (side to move's minus the other side's) exceeds in about 1 of 10000 random and self-play positions and their children. Only the
+    // king mobility count is a real bound. A strict bound for the rest would be over a hundred pawns, since the counts follow the
+    // generators' quirks (a cannon next to a piece touches it once per empty square behind it).
+    int lazyMargin(const XWeights& w) {
+        return std::abs(w.w[XFeatures::MOBILITY]) * 16 + std::abs(w.w[XFeatures::KINGMOBILITY]) * 4 + std::abs(w.w[XFeatures::BNDEFS]) * 10 +
+            std::abs(w.w[XFeatures::RDEFS]) * 11 + std::abs(w.w[XFeatures::CDEFS]) * 14 + std::abs(w.w[XFeatures::QDEFS]) * 11 +
+            std::abs(w.w[XFeatures::KDEFS]) * 28;
+    }
+
+    // Mate scores are relative to the root in the search and to the node in the transposition table
+    static int toTable(int score, int ply) { return (score > MATEBOUND) ? score + ply : ((score < -MATEBOUND) ? score - ply : score); }
+    static int fromTable(int score, int ply) { return (score > MATEBOUND) ? score - ply : ((score < -MATEBOUND) ? score + ply : score); }
+
+    // Capture-only search. Scores are from the perspective of the side to move.
+    int quiesce(XGame game, int remlayers, int alpha, int beta, int ply) {
+        stats.qnodes++;
+        leafcount++;
+        int res = cachedScore(game, alpha, beta, ply);
+        if (remlayers <= 0 || res >= beta || ply >= (int)arena.moves.size()) return res;
+        alpha = std::max(alpha, res);
+
+        XMoveList& legals = arena.moves[ply];
+        game.getAllLegalMoves(legals);
+        for (auto p : legals) {
+            if (game.get(p.first.first + p.second.first, p.first.second + p.second.second).isEmpty()) continue;
+            if (SEE(game, p) < 0) continue; // Losing captures will not raise the stand pat score
+            XGame game2(game);
+            game2.execute(p.first, p.second);
+            game2.sidetomove = !game2.sidetomove;
+            makeAccumulator(game2, p, ply);
+
+            int value = -quiesce(game2, remlayers - 1, -beta, -alpha, ply + 1);
+            res = std::max(res, value);
+            alpha = std::max(alpha, res);
+            if (beta <= alpha) break;
+        }
+        return res;
+    }
+
+    // Negamax alpha-beta. Scores are from the perspective of the side to move, so the root (ply 0) is the maximizing side.
+    // Principal variation search: the first move gets the full window and the rest get a null window scout that is only re-searched if it lands inside (alpha, beta).
+    int abprune(XGame game, int remlayers, int alpha, int beta, int ply = 0) {
+        pvlength[ply] = ply;
+        if (ply == 0) {
+            arena.reserve(remlayers + qlayers + 1, evalbits, network != nullptr);
+            evalkey = fingerprint();
+            quantize();
+            game.setPieceSquare(pstfixed); // Moves below update the sums
+            if (network) arena.accs[0].refresh(*network, game); // and makeAccumulator the network's
+        }
+        if (stopped()) return 0;
+        stats.nodes++;
+        if (remlayers <= 0 || ply >= MAXPLY - 1 || ply >= (int)arena.moves.size()) {
+            leafcount++;
+            return cachedScore(game, alpha, beta, ply);
+        }
+
+        int origalpha = alpha;
+        uint64_t key = game.hash();
+        std::pair<std::pair<int, int>, std::pair<int, int>> ttmove = {{-1, -1}, {0, 0}};
+        int ttscore;
+        int ttdepth;
+        uint8_t ttflag;
+        if (table) stats.ttprobes++;
+        if (table && table->probe(key, ttscore, ttmove, ttdepth, ttflag) && ply > 0 && ttdepth >= remlayers) {
+            stats.tthits++;
+            ttscore = fromTable(ttscore, ply);
+            if (ttflag == XTable::EXACT) return ttscore;
+            if (ttflag == XTable::LOWER && ttscore >= beta) return ttscore;
+            if (ttflag == XTable::UPPER && ttscore <= alpha) return ttscore;
+        }
+
+        if (tablebases && ply > 0) {
+            int dtm;
+            int r = tablebases->probeInTime(game, dtm);
+            if (r != XTablebase::MISSING) {
+                stats.tbhits++;
+                return tablebaseScore(r, dtm, ply);
+            }
+        }
+
+        bool incheck = !game.noChecks();
+        bool prunable = pruning && ply > 0 && !incheck;
+        int staticeval = prunable ? getMaterial(game) : 0;
+
+        if (prunable && remlayers <= 3) {
+            // Reverse futility (static null move) - even giving away a margin we are still above beta
+            if (staticeval - futilityMargin(remlayers) >= beta) return staticeval - futilityMargin(remlayers);
+
+            // Razoring - hopelessly behind, so only captures can save us
+            if (remlayers <= 2 && staticeval + razorMargin(remlayers) <= alpha) {
+                int value = quiesce(game, qlayers, alpha, beta, ply);
+                if (value <= alpha) return value;
+            }
+        }
+
+        XMoveList& legals = arena.moves[ply];
+        game.getAllLegalMoves(legals);
+        if (legals.empty()) return -(MATESCORE - ply); // Checkmated or stalemated, both lose
+        rng.shuffle(legals);
+        orderMoves(game, legals, ttmove, ply);
+
+        // Follow the previous iteration's PV first
+        if (followpv) {
+            followpv = false;
+            if (ply < prevpvlength) {
+                auto it = std::find(legals.begin(), legals.end(), prevpv[ply]);
+                if (it != legals.end()) {
+                    std::rotate(legals.begin(), it, it + 1);
+                    followpv = true;
+                }
+            }
+        }
+
+        // ProbCut - if a capture beats beta by a margin in a shallow search it will very likely beat beta in the full one
+        if (prunable && remlayers >= probcutdepth) {
+            int rbeta = beta + probcutMargin();
+            for (auto p : legals) {
+                if (game.get(p.first.first + p.second.first, p.first.second + p.second.second).isEmpty()) continue;
+                if (SEE(game, p) < 0) continue;
+                XGame game2(game);
+                game2.execute(p.first, p.second);
+                game2.sidetomove = !game2.sidetomove;
+                makeAccumulator(game2, p, ply);
+
+                int value = -abprune(game2, remlayers - 4, -rbeta, -(rbeta - 1), ply + 1);
+                if (value >= rbeta) return value;
+            }
+        }
+
+        bool futile = prunable && remlayers <= 3 && staticeval + futilityMargin(remlayers) <= alpha;
+
+        int res = -MAXSCORE;
+        std::pair<std::pair<int, int>, std::pair<int, int>> best = {{-1, -1}, {0, 0}};
+        int searched = 0;
+        for (auto p : legals) {
+            if (ply == 0 && std::find(excluded.begin(), excluded.end(), p) != excluded.end()) continue;
+            bool capture = !game.get(p.first.first + p.second.first, p.first.second + p.second.second).isEmpty();
+            XGame game2(game);
+            game2.execute(p.first, p.second);
+            game2.sidetomove = !game2.sidetomove;
+
+            // Futility - quiet moves that do not check cannot bring us back up to alpha
+            if (futile && !capture && game2.noChecks()) {
+                res = std::max(res, staticeval + futilityMargin(remlayers));
+                continue;
+            }
+
+            // Late move reductions - late quiet moves and losing captures get a layer less unless they check or we are in check.
+            // A reduced scout that still beats alpha is searched again at full depth.
+            int reduction = 0;
+            if (remlayers >= lmrdepth && searched >= lmrmoves && !incheck && (!capture || SEE(game, p) < 0) && game2.noChecks()) reduction = 1;
+
+            makeAccumulator(game2, p, ply);
+            int value;
+            if (searched == 0) value = -abprune(game2, remlayers - 1, -beta, -alpha, ply + 1);
+            else {
+                value = -abprune(game2, remlayers - 1 - reduction, -(alpha + 1), -alpha, ply + 1);
+                if (value > alpha && reduction) value = -abprune(game2, remlayers - 1, -(alpha + 1), -alpha, ply + 1);
+                if (value > alpha && value < beta) value = -abprune(game2, remlayers - 1, -beta, -alpha, ply + 1);
+            }
+            searched++;
+            stats.children++;
+
+            if (value > res) {
+                res = value;
+                best = p;
+                if (res > alpha) {
+                    pvtable[ply][ply] = p;
+                    for (int i = ply + 1; i < pvlength[ply + 1]; i++) pvtable[ply][i] = pvtable[ply + 1][i];
+                    pvlength[ply] = std::max(pvlength[ply + 1], ply + 1);
+                }
+            }
+            alpha = std::max(alpha, res);
+            if (beta <= alpha) {
+                stats.cutoffs++;
+                if (searched == 1) stats.firstcutoffs++;
+                if (!capture) {
+                    XPiece piece = game.get(p.first);
+                    history[piece.getColor()][piece.getID()][9 * (p.first.second + p.second.second) + p.first.first + p.second.first] += remlayers * remlayers;
+                    if (killers[ply][0] != p) {
+                        killers[ply][1] = killers[ply][0];
+                        killers[ply][0] = p;
+                    }
+                }
+                break;
+            }
+        }
+
+        if (searched) stats.expanded++;
+        if (table && !stopped() && !(ply == 0 && !excluded.empty())) { // A root searched without some of its moves is not a real result
+            stats.ttstores++;
+            uint8_t flag = (res <= origalpha) ? XTable::UPPER : ((res >= beta) ? XTable::LOWER : XTable::EXACT);
+            table->store(key, toTable(res, ply), best, remlayers, flag);
+        }
+        return res;
+    }
+
+    int searchdepth = 2; // Iterative deepening goes up to this many layers
+    int lastscore = 0; // Score of the last completed iteration
+
+    // Completed iteration scores by depth, kept across picks. Our eval swings a lot between odd and even depths
+    // so the aspiration window is centered on the last score of the same parity rather than the previous depth.
+    int iterscores[MAXPLY] = {0};
+    bool iterscored[MAXPLY] = {false};
+
+    // Aspiration window half-width around the previous iteration's score
+    int aspirationMargin() { return valuesfixed[3]; }
+
+    int multipv = 1; // Number of best root moves to find, see pickMulti
+    std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> excluded; // Root moves skipped by the current MultiPV pass
+    std::vector<XSearchResult> lines; // Best lines of the last completed iteration, best first
+
+    int threads = 1; // Lazy SMP - this many threads search the same position, sharing the transposition table
+    int startdepth = 1;
+
+    // The Lazy SMP helpers of pick(), kept from move to move so their eval caches and move buffers stay warm. Copies and assignments
+    // of an XAI start without any.
+    struct Helpers {
+        std::vector<std::shared_ptr<XAI>> engines;
+
+        Helpers() {}
+        Helpers(const Helpers&) {}
+        Helpers& operator=(const Helpers&) {
+            engines.clear();
+            return *this;
+        }
+    };
+    Helpers helpers;
+
+    // Iterative deepening with aspiration windows. Fills chosenmove and the PV arrays.
+    void search(XGame& game, bool verbose = false) {
+        auto start = std::chrono::steady_clock::now();
+        int maxdepth = timed ? MAXPLY - 2 : searchdepth; // On the clock the time manager decides when to stop
+        arena.reserve(maxdepth + qlayers + 1, evalbits, network != nullptr);
+        game.getAllLegalMoves(arena.moves[0]);
+        int legalcount = arena.moves[0].size();
+        for (int depth = startdepth; depth <= maxdepth && !stopped(); depth++) {
+            long long nodesbefore = stats.nodes + stats.qnodes;
+            std::vector<XSearchResult> found;
+            excluded.clear();
+
+            // MultiPV - every pass after the first searches the root without the moves already found
+            for (int line = 0; line < std::max(multipv, 1) && line < legalcount; line++) {
+                int delta = aspirationMargin();
+                int alpha = -MAXSCORE;
+                int beta = MAXSCORE;
+                int center = 0;
+                bool centered = true;
+                if (depth > 2 && iterscored[depth - 2]) center = iterscores[depth - 2];
+                else if (iterscored[depth]) center = iterscores[depth];
+                else centered = false;
+                if (line == 0 && centered && std::abs(center) <= MATEBOUND) {
+                    alpha = center - delta;
+                    beta = center + delta;
+                }
+
+                int value;
+                while (true) {
+                    followpv = (line == 0);
+                    value = abprune(game, depth, alpha, beta);
+                    if (stopped()) break;
+                    if (value <= alpha && alpha > -MAXSCORE) alpha = (delta > valuesfixed[5]) ? -MAXSCORE : value - delta;
+                    else if (value >= beta && beta < MAXSCORE) beta = (delta > valuesfixed[5]) ? MAXSCORE : value + delta;
+                    else break;
+                    delta *= 2;
+                    if (verbose) std::cout << "ASPIRATION FAIL AT DEPTH " << depth << ", WIDENING TO (" << alpha << ", " << beta << ")\n";
+                }
+                if (stopped() || pvlength[0] == 0) break;
+
+                XSearchResult res;
+                res.move = pvtable[0][0];
+                res.score = value;
+                res.depth = depth;
+                res.pv.assign(pvtable[0], pvtable[0] + pvlength[0]);
+                found.push_back(res);
+                excluded.push_back(res.move);
+            }
+
+            if (stopped() || found.empty()) break;
+            excluded.clear();
+            int value = found[0].score;
+            bool bestchanged = depth == startdepth || found[0].move != chosenmove;
+            double scoredrop = (depth == startdepth) ? 0 : (double)lastscore - value;
+            lastscore = value;
+            iterscores[depth] = value;
+            iterscored[depth] = true;
+            chosenmove = found[0].move;
+            prevpvlength = found[0].pv.size(); // Only from a completed iteration, so it always starts with chosenmove
+            for (int i = 0; i < prevpvlength; i++) prevpv[i] = found[0].pv[i];
+            lines = found;
+            stats.iterations.push_back({depth, stats.nodes + stats.qnodes - nodesbefore, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), value});
+
+            if (onprogress) {
+                XSearchResult progress = found[0];
+                progress.stats = stats;
+                onprogress(progress);
+            }
+
+            if (timed && (legalcount == 1 || !time.next(bestchanged, scoredrop, aspirationMargin()))) break;
+        }
+        excluded.clear();
+    }
+
+    // Mate solver. Runs before the search when the side to move has enough attackers over the river.
+    int matenodes = 2000; // Node budget, 0 turns the solver off
+    bool matefound = false; // Set by pick() when the chosen move starts a proven forced mate (the PV is the mating line)
+
+    bool attackingChances(XGame& game) {
+        int attackers = 0;
+        for (int x = 0; x < 9; x++) {
+            for (int y = 0; y < 10; y++) {
+                XPiece piece = game.board[x][y];
+                if (piece.isEmpty() || piece.getColor() != game.sidetomove) continue;
+                if (!(piece.isRook() || piece.isKnight() || piece.isCannon() || piece.isPawn())) continue;
+                if (piece.getColor() ? (y >= 5) : (y < 5)) attackers++;
+            }
+        }
+        return attackers >= 2;
+    }
+
+    bool solveMate(XGame& game) {
+        if (matenodes <= 0 || !attackingChances(game)) return false;
+        XMateSolver solver;
+        solver.nodebudget = matenodes;
+        if (timed) solver.maxms = time.optimum / 4; // Leaves most of the move for the search if no mate turns up
+        bool res = solver.solve(game);
+        if (res && !solver.pv.empty()) {
+            leafcount = 0;
+            stats = XSearchStats();
+            stats.nodes = solver.nodes;
+            lines.clear();
+            chosenmove = solver.pv[0];
+            prevpvlength = std::min((int)solver.pv.size(), MAXPLY);
+            for (int i = 0; i < prevpvlength; i++) prevpv[i] = solver.pv[i];
+            lastscore = MATESCORE - (int)solver.pv.size();
+            matefound = true;
+        }
+        return matefound;
+    }
+
+    // Opening book, shared between engines. A book move is played without searching.
+    std::shared_ptr<XBook> book;
+
+    bool probeBook(XGame& game) {
+        std::pair<std::pair<int, int>, std::pair<int, int>> move;
+        if (!book || !book->probe(game, rng, move)) return false;
+        leafcount = 0;
+        stats = XSearchStats();
+        lines.clear();
+        chosenmove = move;
+        prevpvlength = 0;
+        lastscore = 0;
+        return true;
+    }
+
+    // Endgame tablebases, shared between engines. Positions they cover are scored exactly in the search, and at the root the move
+    // is read straight from the tables.
+    std::shared_ptr<XTablebase> tablebases;
+
+    // Wins score far above any eval, sooner mates higher. Results come from probeInTime(), so every win scored here is mated before
+    // the move limit (XGame::TLE).
+    int tablebaseScore(int result, int dtm, int ply) {
+        if (result == XTablebase::DRAW) return 0;
+        int score = MATESCORE - ply - dtm;
+        return (result == XTablebase::WIN) ? score : -score;
+    }
+
+    bool probeTablebase(XGame& game) {
+        if (!tablebases) return false;
+        int dtm;
+        int r = tablebases->probeInTime(game, dtm);
+        if (r == XTablebase::MISSING) return false;
+
+        std::pair<std::pair<int, int>, std::pair<int, int>> best = {{-1, -1}, {0, 0}};
+        int bestscore = -MAXSCORE;
+        for (auto p : game.getAllLegalMoves()) {
+            XGame game2(game);
+            game2.execute(p.first, p.second);
+            game2.sidetomove = !game2.sidetomove;
+            int childdtm;
+            int childr = tablebases->probeInTime(game2, childdtm);
+            int score = (childr == XTablebase::MISSING) ? -MATESCORE : -tablebaseScore(childr, childdtm, 1);
+            if (score > bestscore) {
+                bestscore = score;
+                best = p;
+            }
+        }
+        if (best.first.first < 0) return false;
+
+        leafcount = 0;
+        stats = XSearchStats();
+        stats.tbhits = 1;
+        lines.clear();
+        chosenmove = best;
+        prevpvlength = 0;
+        lastscore = tablebaseScore(r, dtm, 0);
+        matefound = (r == XTablebase::WIN); // A tablebase win is a proven forced mate too
+        return true;
+    }
+
+    static std::string moveString(std::pair<std::pair<int, int>, std::pair<int, int>> p) {
+        return Position(p.first).toString() + Position(p.first.first + p.second.first, p.first.second + p.second.second).toString();
+    }
+
+    // Pondering - after pick() returns, keep searching the position after our move and the expected reply on a background copy of the engine.
+    // The copy shares our transposition table. If the opponent plays the expected reply the next pick() waits for that search and uses it,
+    // otherwise the background search is stopped and thrown away.
+    struct Ponder {
+        std::shared_ptr<XAI> engine;
+        std::atomic<bool> stop{false};
+        std::atomic<bool> done{false}; // The ponder search finished on its own
+        std::thread worker;
+        uint64_t key = 0; // Hash of the position being pondered
+
+        ~Ponder() {
+            stop = true;
+            if (worker.joinable()) worker.join();
+        }
+    };
+
+    bool ponder = false;
+    std::shared_ptr<Ponder> pondering;
+    int ponderhits = 0;
+
+    void startPonder(XGame game) {
+        if (prevpvlength < 2) return;
+        for (int i = 0; i < 2; i++) {
+            game.execute(prevpv[i].first, prevpv[i].second);
+            game.sidetomove = !game.sidetomove;
+        }
+        if (game.getAllLegalMoves().empty()) return;
+
+        pondering = std::make_shared<Ponder>();
+        pondering->key = game.hash();
+        pondering->engine = std::make_shared<XAI>(*this);
+        XAI* engine = pondering->engine.get();
+        shareState(*engine);
+        engine->ponder = false;
+        engine->statslog = nullptr;
+        engine->onprogress = nullptr;
+        engine->stopflag = &pondering->stop;
+        engine->clock = engine->timecontrol = XClock();
+        if (onClock()) engine->searchdepth = MAXPLY - 2; // Stopped by stopPonder instead
+        engine->rng.seed(rng.next());
+        Ponder* p = pondering.get();
+        pondering->worker = std::thread([engine, game, p]() {
+            engine->pick(game);
+            p->done = true;
+        });
+    }
+
+    // Returns true if the pondered position is the one we are asked about, in which case its results are copied over.
+    // On the clock a hit keeps searching until this move's budget is used, then it is stopped; it only counts if an iteration finished.
+    bool stopPonder(XGame& game) {
+        if (!pondering) return false;
+        bool hit = pondering->key == game.hash();
+        if (hit && timed) {
+            while (!pondering->done && time.elapsed() < time.optimum) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!hit || timed) pondering->stop = true;
+        pondering->worker.join();
+        XAI* engine = pondering->engine.get();
+        if (hit && !pondering->done && engine->stats.iterations.empty()) hit = false;
+
+        if (hit) {
+            chosenmove = engine->chosenmove;
+            prevpvlength = engine->prevpvlength;
+            for (int i = 0; i < prevpvlength; i++) prevpv[i] = engine->prevpv[i];
+            lastscore = engine->lastscore;
+            leafcount = engine->leafcount;
+            stats = engine->stats;
+            lines = engine->lines;
+            matefound = engine->matefound;
+            ponderhits++;
+        }
+        pondering.reset();
+        return hit;
+    }
+
+    // Search reuse - consecutive picks in one game keep the transposition table, history, killers and the expected line, so the
+    // subtree after the opponent's reply is already warm. Call newGame() between games.
+    bool reuse = true;
+    bool warm = false; // There is state from an earlier pick to reuse
+    uint64_t expectedkey = 0; // Position after our last move and the reply we expect
+
+    void setTimeControl(XClock control) { timecontrol = clock = control; }
+
+    void newGame() {
+        clock = timecontrol;
+        if (table) table->clear();
+        clearOrdering();
+        prevpvlength = 0;
+        for (int i = 0; i < MAXPLY; i++) iterscored[i] = false;
+        warm = false;
+        for (auto& h : helpers.engines) { // Their table is ours
+            h->clearOrdering();
+            h->prevpvlength = 0;
+            for (int i = 0; i < MAXPLY; i++) h->iterscored[i] = false;
+        }
+    }
+
+    // Gets the search state ready for a pick on game. Returns false if nothing was kept.
+    bool reuseState(XGame& game) {
+        if (!reuse || !warm || !table) return false;
+
+        // Older cutoffs count for less, and the killers move up two plies along with the root
+        for (int c = 0; c < 2; c++) {
+            for (int i = 0; i < 9; i++) {
+                for (int j = 0; j < 90; j++) history[c][i][j] /= 2;
+            }
+        }
+        for (int i = 0; i < MAXPLY; i++) {
+            for (int k = 0; k < 2; k++) killers[i][k] = (i + 2 < MAXPLY) ? killers[i + 2][k] : std::make_pair(std::make_pair(-1, -1), std::make_pair(0, 0));
+        }
+
+        // The opponent played the expected reply, the rest of the PV is searched first
+        if (game.hash() == expectedkey && prevpvlength > 2) {
+            for (int i = 2; i < prevpvlength; i++) prevpv[i - 2] = prevpv[i];
+            prevpvlength -= 2;
+        }
+        else prevpvlength = 0;
+        return true;
+    }
+
+	std::pair<std::pair<int, int>, std::pair<int, int>> pick(XGame game, std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>>& pv, bool verbose = false) {
+	    // return pickdepth2(game, false);
+
+        auto pickstart = std::chrono::steady_clock::now();
+        matefound = false;
+        timed = onClock();
+        timeout = false;
+        timechecks = 0;
+        if (timed) time.begin(clock); // Ponder hits and the mate solver are held to the same budget as the search
+        if (stopPonder(game)) {
+            if (verbose) std::cout << "PONDER HIT\n";
+        }
+        else if (probeBook(game)) {
+            if (verbose) std::cout << "BOOK MOVE\n";
+        }
+        else if (probeTablebase(game)) {
+            if (verbose) std::cout << "TABLEBASE " << ((lastscore > 0) ? "WIN" : ((lastscore < 0) ? "LOSS" : "DRAW")) << "\n";
+        }
+        else if (solveMate(game)) {
+            if (verbose) std::cout << "FORCED MATE IN " << (prevpvlength + 1) / 2 << "\n";
+        }
+        else {
+            auto start = std::chrono::steady_clock::now();
+            leafcount = 0;
+            stats = XSearchStats();
+            lines.clear();
+            auto legals = game.getAllLegalMoves();
+            chosenmove = legals.empty() ? std::make_pair(std::make_pair(-1, -1), std::make_pair(0, 0)) : legals[0];
+            if (!table) table = std::make_shared<XTable>(ttbits);
+            if (reuseState(game)) {
+                if (verbose) std::cout << "REUSING SEARCH STATE" << ((prevpvlength > 0) ? " (EXPECTED REPLY)" : "") << "\n";
+            }
+            else {
+                table->clear();
+                clearOrdering();
+                prevpvlength = 0;
+            }
+
+            // Helpers run the same iterative deepening on their own copies, every other one a layer deeper, until the main search is done
+            std::atomic<bool> stop(false);
+            std::vector<std::thread> workers;
+            helpers.engines.resize(std::max(threads - 1, 0));
+            for (int i = 1; i < threads; i++) {
+                std::shared_ptr<XAI>& slot = helpers.engines[i - 1];
+                if (!slot) slot = std::make_shared<XAI>(*this);
+                XAI* helper = slot.get();
+                helper->copySettings(*this);
+                helper->leafcount = 0;
+                helper->stats = XSearchStats();
+                helper->prevpvlength = 0;
+                std::memcpy(helper->iterscores, iterscores, sizeof(iterscores));
+                std::memcpy(helper->iterscored, iterscored, sizeof(iterscored));
+                helper->table = table;
+                helper->stopflag = &stop;
+                helper->threads = 1;
+                helper->startdepth = 1 + (i & 1);
+                helper->searchdepth = timed ? MAXPLY - 2 : searchdepth + (i & 1);
+                helper->clock = helper->timecontrol = XClock();
+                helper->chosenmove = chosenmove;
+                helper->rng.seed(rng.next());
+                helper->clearOrdering();
+                helper->statslog = nullptr;
+                helper->onprogress = nullptr;
+                helper->maxnodes = 0; // The main search's limit ends the move
+                helper->ponder = false;
+                helper->multipv = 1;
+                workers.emplace_back([helper, game]() mutable { helper->search(game); });
+            }
+
+            search(game, verbose);
+
+            stop = true;
+            for (auto& w : workers) w.join();
+            for (int i = 1; i < threads; i++) {
+                XAI* helper = helpers.engines[i - 1].get();
+                leafcount += helper->leafcount;
+                stats.add(helper->stats);
+                helper->stopflag = nullptr; // stop goes out of scope
+            }
+            stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        pv.assign(prevpv, prevpv + prevpvlength);
+        if (pv.empty()) pv = {chosenmove};
+
+        // Charge the move to the clock, also once it has run out so the next control still arrives
+        if (timecontrol.remaining > 0 || clock.remaining > 0) {
+            clock.remaining += clock.increment - std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pickstart).count();
+            if (clock.movestogo > 0 && --clock.movestogo == 0) {
+                clock.remaining += timecontrol.remaining;
+                clock.movestogo = timecontrol.movestogo;
+            }
+        }
+        timed = false;
+
+        warm = (table != nullptr);
+        expectedkey = 0;
+        if (prevpvlength >= 2) {
+            XGame expected(game);
+            for (int i = 0; i < 2; i++) {
+                expected.execute(prevpv[i].first, prevpv[i].second);
+                expected.sidetomove = !expected.sidetomove;
+            }
+            expectedkey = expected.hash();
+        }
+
+        if (verbose) {
+            std::cout << leafcount << " LEAF NODES CHECKED\n";
+            std::cout << "PV";
+            for (auto p : pv) std::cout << " " << moveString(p);
+            std::cout << " (" << lastscore / (double)SCALE << ")\n";
+            for (int i = 1; i < (int)lines.size(); i++) {
+                std::cout << "LINE " << (i + 1);
+                for (auto p : lines[i].pv) std::cout << " " << moveString(p);
+                std::cout << " (" << lines[i].score / (double)SCALE << ")\n";
+            }
+        }
+        if (statslog) (*statslog) << stats.toJSON(moveString(chosenmove)) << "\n";
+
+        if (ponder && !stopped()) startPonder(game);
+        return chosenmove;
+	}
+
+	std::pair<std::pair<int, int>, std::pair<int, int>> pick(XGame game, bool verbose = false) {
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pv;
+        return pick(game, pv, verbose);
+	}
+
+    // Top k root moves with their scores and PVs, best first. Each line is one more pass over the root with the earlier moves excluded,
+    // sharing the transposition table, so this costs much less than k separate searches.
+    std::vector<XSearchResult> pickMulti(XGame game, int k, bool verbose = false) {
+        int oldmultipv = multipv;
+        bool oldponder = ponder;
+        multipv = k;
+        ponder = false;
+        pick(game, verbose);
+        multipv = oldmultipv;
+        ponder = oldponder;
+        if (lines.empty() && game.hasLegalMoves()) { // The book, tablebases, mate solver and ponder hits pick a move without lines
+            XSearchResult res;
+            res.move = chosenmove;
+            res.score = lastscore;
+            res.pv.assign(prevpv, prevpv + prevpvlength);
+            res.stats = stats;
+            return {res};
+        }
+        return lines;
+    }
+
+    // Runs pick() on a background copy of this engine (sharing its transposition table) and returns straight away.
+    // The caller can stop the search, poll the best move so far or wait on the future for the result.
+    XSearchHandle startSearch(XGame game, XSearchLimits limits = XSearchLimits()) {
+        if (!table) table = std::make_shared<XTable>(ttbits);
+        XSearchHandle handle;
+        handle.state = std::make_shared<XSearchHandle::State>();
+
+        std::shared_ptr<XAI> engine = std::make_shared<XAI>(*this);
+        shareState(*engine);
+        engine->ponder = false;
+        engine->statslog = nullptr;
+        engine->stopflag = &handle.state->stop;
+        engine->rng.seed(rng.next());
+        if (limits.depth > 0) engine->searchdepth = limits.depth;
+        engine->maxnodes = limits.nodes;
+        engine->clock = engine->timecontrol = XClock();
+        engine->clock.movetime = limits.movetime;
+
+        std::shared_ptr<XSearchHandle::State> state = handle.state;
+        std::function<void(const XSearchResult&)> callback = limits.onprogress;
+        engine->onprogress = [state, callback](const XSearchResult& progress) {
+            {
+                std::lock_guard<std::mutex> guard(state->lock);
+                state->best = progress;
+            }
+            if (callback) callback(progress);
+        };
+
+        {
+            std::lock_guard<std::mutex> guard(state->lock);
+            auto legals = game.getAllLegalMoves();
+            state->best.move = legals.empty() ? std::make_pair(std::make_pair(-1, -1), std::make_pair(0, 0)) : legals[0];
+        }
+
+        // The engine copy and the state are kept alive by the task until it finishes
+        handle.result = std::async(std::launch::async, [engine, state, game]() {
+            XSearchResult res;
+            res.move = engine->pick(game, res.pv);
+            res.score = engine->lastscore;
+            res.depth = engine->stats.iterations.empty() ? 0 : engine->stats.iterations.back().depth;
+            res.stats = engine->stats;
+            return res;
+        }).share();
+        return handle;
+    }
+    
+    // mob / bndef / rdef / cdef / qdef / kmob / kdef / chk / ckmt / movecount
+
+	std::string toString() {
+        std::string res = "PP " + std::to_string(promotedpawn) + " MOB " + std::to_string(mob) + " BN " + std::to_string(bndef) + " RDEF " + std::to_string(rdef) + " CDEF " + std::to_string(cdef);
+        res = res + " QDEF " + std::to_string(qdef) + " KMOB " + std::to_string(kmob) + " KDEF " + std::to_string(kdef);
+        res = res + " CHK " + std::to_string(chk) + " CKMT " + std::to_string(ckmt) + " MCNT " + std::to_string(movecount);
+        std::string table = pieceSquareString();
+        if (!table.empty()) res = res + " PST " + table;
+        return res;
+    }
+
+    // The non-zero piece-square entries as "<piece><square>=<value>" separated by spaces, e.g. "R4=0.250000 S40=-0.125000". Pieces
+    // are the XPiece symbols and squares are 9 * rank + file from red's side.
+    std::string pieceSquareString() {
+        std::string res;
+        XPiece symbols;
+        for (int id = 2; id < 9; id++) {
+            for (int sq = 0; sq < 90; sq++) {
+                if (pst[id][sq] == 0) continue;
+                if (!res.empty()) res += " ";
+                res = res + symbols.ids[id] + std::to_string(sq) + "=" + std::to_string(pst[id][sq]);
+            }
+        }
+        return res;
+    }
+
+    // Reads pieceSquareString()'s format into pst, which starts from all zeros. Returns false at the first malformed entry.
+    bool readPieceSquare(const std::string& table) {
+        std::memset(pst, 0, sizeof(pst));
+        std::istringstream in(table);
+        std::string token;
+        XPiece symbols;
+        while (in >> token) {
+            char* id = std::find(symbols.ids + 2, symbols.ids + 9, token[0]);
+            int sq;
+            double value;
+            if (id == symbols.ids + 9 || std::sscanf(token.c_str() + 1, "%d=%lf", &sq, &value) != 2 || sq < 0 || sq >= 90) return false;
+            pst[id - symbols.ids][sq] = value;
+        }
+        return true;
+    }
+};
+
+// When Genetic::test may end a game before checkmate, stalemate or the move limit. Off unless the caller turns it on, so games are
+// played out by default.
+// Score rules need both engines to agree: every ply of the streak counts, whichever engine searched it.
+struct XAdjudication {
+    bool enabled = false;
+    double resignscore = 10; // Scores beyond this (more than a chariot) for resignplies plies in a row end the game as a win
+    int resignplies = 8;
+    double drawscore = 1; // Scores that move less than this for drawplies plies in a row, once drawstart plies are played, end it as a draw
+    int drawplies = 30;
+    int drawstart = 60;
+    bool material = true; // Draw when neither side has a chariot, horse, cannon or soldier left
+    std::shared_ptr<XTablebase> tablebases; // Exact results wherever the tables cover the position
+};
+
+namespace Genetic {
+    
+// Whether the engine's last pick() started a proven forced mate
+template <typename T>
+bool provenMate(T& ai) { return false; }
+
+bool provenMate(XAI& ai) { return ai.matefound; }
+
+// Forgets whatever the engine kept from its previous game
+template <typename T>
+void newGame(T& ai) {}
+
+void newGame(XAI& ai) { ai.newGame(); }
+
+// Score of the engine's last pick() from its own side, if it has one
+template <typename T>
+bool searchScore(T& ai, double& score) { return false; }
+
+bool searchScore(XAI& ai, double& score) {
+    score = ai.lastscore / (double)XAI::SCALE;
+    return true;
+}
+
+// Neither side can mate any more
+bool insufficientMaterial(XGame& game) {
+    for (int x = 0; x < 9; x++) {
+        for (int y = 0; y < 10; y++) {
+            XPiece piece = game.board[x][y];
+            if (piece.isRook() || piece.isKnight() || piece.isCannon() || piece.isPawn()) return false;
+        }
+    }
+    return true;
+}
+
+// Plays the first few plies by sampling among the default engine's top k moves, so games between the same pair of engines do not all start alike
+XGame opening(XRandom& rng, int plies = 4, int k = 3) {
+    XGame game;
+    XAI ai;
+    ai.rng.seed(rng.next());
+    for (int i = 0; i < plies && !game.gameover(); i++) {
+        std::vector<XSearchResult> lines = ai.pickMulti(game, k);
+        if (lines.empty()) break;
+        auto move = lines[rng.nextInt(lines.size())].move;
+        game.execute(move.first, move.second);
+        game.sidetomove = !game.sidetomove;
+    }
+    return game;
+}
+
+// Play with a1 white and a2 black. Both engines are reseeded from rng for every game.
+// Works with any engine that has an rng and a pick(XGame), so XAI can play XMCTS (see mcts.h).
+// Games that are clearly decided are adjudicated as set in adj: a win counts 2 like a checkmate, a draw 0.
+template <typename A, typename B>
+int test(A a1, B a2, XRandom& rng, bool verbose = false, int games = 1, int openingplies = 0, XAdjudication adj = XAdjudication()) {
+	int res = 0;
+	for (int i = 0; i < games; i++) {
+    XGame game = opening(rng, openingplies);
+    a1.rng.seed(rng.next());
+    a2.rng.seed(rng.next());
+    newGame(a1);
+    newGame(a2);
+    int plies = 0;
+    int redstreak = 0; // Plies in a row scored as won for red, or for black below
+    int blackstreak = 0;
+    int drawstreak = 0;
+    double drawanchor = 0; // Score at the start of the draw streak
+    
+    while (true) { // a1 white a2 black
+        bool red = game.sidetomove;
+        auto move = red ? (a1.pick(game)) : (a2.pick(game));
+        if (move.first.first < 0) { // No legal moves, the opening already ended the game
+            res += game.checkmate() ? (red ? -2 : 2) : (red ? -1 : 1);
+            break;
+        }
+        bool mating = red ? provenMate(a1) : provenMate(a2);
+        double score = 0;
+        bool scored = red ? searchScore(a1, score) : searchScore(a2, score);
+        if (scored && !red) score = -score; // Red's point of view
+        plies++;
+        game.execute(move.first, move.second);
+        game.sidetomove = !game.sidetomove;
+        
+        if (verbose) std::cout << game.toString() << "\n";
+            
+        if (mating || game.checkmate()) { // A proven forced mate ends the game right away
+            if (verbose) std::cout << game.toString() << "\n";
+            if (verbose) std::cout << ( game.sidetomove ? "BLACK" : "WHITE" ) << " WINS\n";
+            res += game.sidetomove ? (-2) : (2);
+			break;
+        }
+        
+        if (game.stalemate()) {
+            if (verbose) std::cout << game.toString() << "\n";
+            if (verbose) std::cout << "STALEMATE/DRAW\n";
+            res += game.sidetomove ? (-1) : 1;
+			break;
+        }
+
+        if (!adj.enabled) continue;
+        redstreak = (scored && score >= adj.resignscore) ? redstreak + 1 : 0;
+        blackstreak = (scored && score <= -adj.resignscore) ? blackstreak + 1 : 0;
+        if (scored && plies > adj.drawstart && std::abs(score) < adj.resignscore && drawstreak && std::abs(score - drawanchor) <= adj.drawscore) drawstreak++;
+        else {
+            drawstreak = (scored && plies > adj.drawstart && std::abs(score) < adj.resignscore) ? 1 : 0;
+            drawanchor = score;
+        }
+
+        int dtm;
+        int tb = adj.tablebases ? adj.tablebases->probeInTime(game, dtm) : XTablebase::MISSING;
+        if (tb == XTablebase::WIN || tb == XTablebase::LOSS) {
+            bool redwins = (tb == XTablebase::WIN) == game.sidetomove;
+            if (verbose) std::cout << "ADJUDICATED BY TABLEBASE, " << (redwins ? "WHITE" : "BLACK") << " WINS\n";
+            res += redwins ? 2 : -2;
+            break;
+        }
+        if (redstreak >= adj.resignplies || blackstreak >= adj.resignplies) {
+            if (verbose) std::cout << (redstreak ? "BLACK" : "WHITE") << " RESIGNS\n";
+            res += redstreak ? 2 : -2;
+            break;
+        }
+        if (tb == XTablebase::DRAW || drawstreak >= adj.drawplies || (adj.material && insufficientMaterial(game))) {
+            if (verbose) std::cout << "ADJUDICATED DRAW\n";
+            break;
+        }
+
+		// std::cout << game.toString() << "\n";
+    }
+
+	}
+
+	return res;
+}
+
+// Every pairing gets its own generator seeded from rng, so the results do not depend on the order the games are played in
+std::vector<XAI> tournament(std::vector<XAI> ais, XRandom& rng, bool verbose = false, int gamesperround = 1, XAdjudication adj = XAdjudication()) {
+    rng.shuffle(ais);
+    std::vector<XAI> res;
+    for (int i = 0; i < ais.size() - 1; i += 2) {
+        XRandom worker(rng.next());
+        int val = test(ais[i], ais[i + 1], worker, false, gamesperround, 0, adj);
+        if (val > 0) res.push_back(XAI(ais[i]));
+        else if (val < 0) res.push_back(XAI(ais[i + 1]));
+        else {
+            if (rng.nextInt(2) == 0) res.push_back(XAI(ais[i]));
+            else res.push_back(XAI(ais[i + 1]));
+        }
+        if (verbose) std::cout << "X";
+    }
+    if (verbose) std::cout << "\n";
+    return res;
+}
+
+// mob / rbndef / qdef / kmob / kdef / oo / chk / ckmt / movecount
+
+XAI cross(XAI a1, XAI a2, XRandom& rng) {
+    XAI res(a1);
+	if (rng.nextInt(2) == 0) res.promotedpawn = a2.promotedpawn;
+    if (rng.nextInt(2) == 0) res.mob = a2.mob;
+    if (rng.nextInt(2) == 0) res.bndef = a2.bndef;
+	if (rng.nextInt(2) == 0) res.rdef = a2.rdef;
+	if (rng.nextInt(2) == 0) res.cdef = a2.cdef;
+    if (rng.nextInt(2) == 0) res.qdef = a2.qdef;
+    if (rng.nextInt(2) == 0) res.kmob = a2.kmob;
+    if (rng.nextInt(2) == 0) res.kdef = a2.kdef;
+    if (rng.nextInt(2) == 0) res.chk = a2.chk;
+    if (rng.nextInt(2) == 0) res.ckmt = a2.ckmt;
+    if (rng.nextInt(2) == 0) res.movecount = a2.movecount;
+    for (int id = 2; id < 9; id++) {
+        if (rng.nextInt(2) == 0) std::memcpy(res.pst[id], a2.pst[id], sizeof(res.pst[id]));
+    }
+    return res;
+}
+
+double randf(XRandom& rng) {
+    return rng.nextDouble();
+}
+
+// mob / bndef / rdef / qdef / cdef / kmob / kdef / oo / chk / ckmt / movecount
+
+XAI mutate(XAI ai, XRandom& rng) {
+    XAI res(ai);
+    int beep = rng.nextInt(128);
+	while (beep > 96) beep = rng.nextInt(128);
+    if (beep == 0) res.mob = randf(rng) * 4 - 2;
+    if (beep == 1) res.bndef = randf(rng) * 4 - 2;
+    if (beep == 2) res.qdef = randf(rng) * 4 - 2;
+	if (beep == 3) res.rdef = randf(rng) * 4 - 2;
+	if (beep == 4) res.cdef = randf(rng) * 4 - 2;
+    if (beep == 5) res.kmob = randf(rng) * 4 - 2;
+    if (beep == 6) res.kdef = randf(rng) * -4 + 2;
+    if (beep == 7) res.chk = randf(rng) * 4 - 2;
+    // if (beep == 7) res.ckmt = randf(rng) * 400;
+    if (beep == 8) res.movecount = (0.5 - randf(rng)) * 0.5;
+	if (beep == 9) res.promotedpawn = randf(rng) * 8 - 4;
+	if (beep >= 10 && beep < 20) res.pst[2 + rng.nextInt(7)][rng.nextInt(90)] += randf(rng) - 0.5; // Nudge one square
+    return res;
+}
+
+XAI randomAI(XRandom& rng) {
+    XAI res;
+	res.promotedpawn = randf(rng) * 8 - 4;
+    res.mob = randf(rng) * 4 - 2;
+    res.bndef = randf(rng) * 4 - 2;
+	res.rdef = randf(rng) * 4 - 2;
+	res.cdef = randf(rng) * 4 - 2;
+    res.qdef = randf(rng) * 4 - 2;
+    res.kmob = randf(rng) * 4 - 2;
+    res.kdef = randf(rng) * -4 + 2;
+    res.chk = randf(rng) * 4 - 2;
+    // if (beep == 7) res.ckmt = randf(rng) * 400;
+    res.movecount = (0.5 - randf(rng)) * 0.5;
+    return res;
+}
+
+}
+
 #endif
\ No newline at end of file
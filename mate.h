@@ -0,0 +1,184 @@
+#ifndef MATE_H
+#define MATE_H
+
+#include "xiangqi.h"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+
+// Depth-first proof-number (df-pn) search for forced checkmates. The attacker (side to move at the root) only plays checks and the
+// defender tries every legal reply, so the tree stays narrow and long mates are found well past the reach of the alpha-beta search.
+// Proof and disproof numbers live in the solver's own hash table. The search gives up once it has used its node budget or its time.
+class XMateSolver {
+	public:
+	static constexpr uint32_t INF = 100000000;
+
+	struct Entry {
+		uint32_t pn = 1;
+		uint32_t dn = 1;
+		uint32_t dist = 0; // Once proven, plies to mate along the proof
+	};
+
+	int nodebudget = 20000;
+	double maxms = 0; // Time limit in milliseconds, 0 for none
+	int maxdepth = 31; // Plies. Deeper lines count as disproven so perpetual checks cannot run away.
+	int nodes = 0;
+
+	std::unordered_map<uint64_t, Entry> table;
+	std::vector<uint64_t> path; // Positions on the current line, repeating one counts as disproven
+	std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> pv; // Mating line after a successful solve()
+
+	std::chrono::steady_clock::time_point start;
+	bool outoftime = false;
+
+	// The clock is only read every 64 nodes
+	bool exhausted() {
+		if (!outoftime && maxms > 0 && (nodes & 63) == 0) outoftime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >= maxms;
+		return outoftime || nodes >= nodebudget;
+	}
+
+	Entry lookup(uint64_t key) {
+		auto it = table.find(key);
+		return (it == table.end()) ? Entry() : it->second;
+	}
+
+	// Moves worth trying at a node: checks for the attacker, everything for the defender
+	std::vector<std::pair<std::pair<std::pair<int, int>, std::pair<int, int>>, XGame>> children(XGame& game, bool attacker) {
+		std::vector<std::pair<std::pair<std::pair<int, int>, std::pair<int, int>>, XGame>> res;
+		for (auto p : game.getAllLegalMoves()) {
+			XGame game2(game);
+			game2.execute(p.first, p.second);
+			game2.sidetomove = !game2.sidetomove;
+			if (attacker && game2.noChecks()) continue;
+			res.push_back({p, game2});
+		}
+		return res;
+	}
+
+	// Expands game until its proof number reaches thpn or its disproof number reaches thdn
+	void mid(XGame& game, bool attacker, uint32_t thpn, uint32_t thdn, int depth) {
+		uint64_t key = game.hash();
+		nodes++;
+
+		auto moves = children(game, attacker);
+		Entry e;
+		if (moves.empty()) { // No checks left for the attacker, or the defender is mated
+			e.pn = attacker ? INF : 0;
+			e.dn = attacker ? 0 : INF;
+			e.dist = 0;
+			table[key] = e;
+			return;
+		}
+		if (depth >= maxdepth) {
+			e.pn = INF;
+			e.dn = 0;
+			table[key] = e;
+			return;
+		}
+
+		path.push_back(key);
+		while (true) {
+			// At attacker nodes one proven child is enough (pn = min, dn = sum). At defender nodes it is the other way round.
+			uint32_t minval = INF, second = INF, sum = 0;
+			int best = -1;
+			uint32_t bestother = 0;
+			for (int i = 0; i < (int)moves.size(); i++) {
+				uint64_t ckey = moves[i].second.hash();
+				Entry c = lookup(ckey);
+				if (std::find(path.begin(), path.end(), ckey) != path.end()) c.pn = INF, c.dn = 0;
+				uint32_t val = attacker ? c.pn : c.dn;
+				uint32_t other = attacker ? c.dn : c.pn;
+				if (val < minval) {
+					second = minval;
+					minval = val;
+					best = i;
+					bestother = other;
+				}
+				else if (val < second) second = val;
+				sum = std::min(INF, sum + other);
+			}
+
+			e.pn = attacker ? minval : sum;
+			e.dn = attacker ? sum : minval;
+			if (e.pn >= thpn || e.dn >= thdn || exhausted()) break;
+
+			uint32_t th1 = std::min(attacker ? thpn : thdn, second + 1);
+			uint32_t th2 = std::min(INF, (attacker ? thdn : thpn) - sum + bestother);
+			if (attacker) mid(moves[best].second, false, th1, th2, depth + 1);
+			else mid(moves[best].second, true, th2, th1, depth + 1);
+		}
+		path.pop_back();
+
+		// The attacker takes the quickest proven child and the defender holds out as long as it can. Each proven child was proven
+		// before this node, so the distance always drops along a line and following it cannot cycle.
+		if (e.pn == 0) {
+			e.dist = attacker ? INF : 0;
+			for (auto& m : moves) {
+				Entry c = lookup(m.second.hash());
+				if (c.pn != 0) continue;
+				e.dist = attacker ? std::min(e.dist, c.dist + 1) : std::max(e.dist, c.dist + 1);
+			}
+		}
+		table[key] = e;
+	}
+
+	// Returns true if the side to move can force checkmate. The mating line is left in pv, and it is only reported when it really
+	// ends in checkmate before the move limit (XGame::TLE) runs out.
+	// Proofs are not shortest mates, so after each one the search runs again with maxdepth below its length until the node budget runs
+	// out or no shorter mate exists. Without this, an engine that solves again every move can keep finding longer proofs and never mate.
+	bool solve(XGame game) {
+		nodes = 0;
+		start = std::chrono::steady_clock::now();
+		outoftime = false;
+		int limit = maxdepth;
+		std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> best;
+		while (maxdepth > 0 && !exhausted() && prove(game)) {
+			best = pv;
+			maxdepth = (int)pv.size() - 2;
+		}
+		maxdepth = limit;
+		pv = best;
+		return !pv.empty();
+	}
+
+	// One proof search within maxdepth plies
+	bool prove(XGame game) {
+		table.clear();
+		path.clear();
+		pv.clear();
+		mid(game, true, INF, INF, 0);
+		if (lookup(game.hash()).pn != 0) return false;
+
+		// Follow the proof: the attacker's shortest mate against the defender's longest resistance
+		bool attacker = true;
+		while ((int)pv.size() < maxdepth) {
+			auto moves = children(game, attacker);
+			if (moves.empty()) break;
+			int pick = -1;
+			uint32_t pickdist = 0;
+			for (int i = 0; i < (int)moves.size(); i++) {
+				Entry c = lookup(moves[i].second.hash());
+				if (c.pn != 0) continue;
+				if (pick == -1 || (attacker ? c.dist < pickdist : c.dist > pickdist)) {
+					pick = i;
+					pickdist = c.dist;
+				}
+			}
+			if (pick == -1) break;
+			pv.push_back(moves[pick].first);
+			game = moves[pick].second;
+			if (game.TLE()) break;
+			attacker = !attacker;
+		}
+		if (pv.empty() || game.TLE() || !game.checkmate()) {
+			pv.clear();
+			return false;
+		}
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "xiangqi.h"
+#include "genetic.h"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cmath>
+
+// Monte Carlo tree search as an alternative to XAI's alpha-beta. There are no rollouts: leaves are scored with an XAI's getScore
+// squashed into (-1, 1), and children are picked with PUCT. Several threads can grow the same tree, spread apart by virtual loss.
+// The tree is kept between calls to pick() and the subtree under the actual game position is reused.
+class XMCTS {
+	public:
+	struct Node {
+		std::pair<std::pair<int, int>, std::pair<int, int>> move = {{0, 0}, {0, 0}}; // Move that leads here from the parent
+		uint64_t key = 0; // Hash of the position
+		double prior = 1;
+		std::atomic<int> visits{0};
+		std::atomic<double> value{0}; // Sum of results from the point of view of the side that played move
+		bool expanded = false;
+		bool terminal = false;
+		double terminalvalue = 0; // From the point of view of the side to move
+		std::vector<std::unique_ptr<Node>> children;
+		std::mutex lock;
+	};
+
+	XAI eval; // Weights for the value estimate
+	int playouts = 400; // Per pick()
+	int threads = 1;
+	double cpuct = 1.5;
+	double virtualloss = 1;
+	XRandom rng;
+
+	std::unique_ptr<Node> root;
+	int reused = 0; // Visits carried over from the previous pick()
+
+	XMCTS() {}
+
+	XMCTS(XAI ai) : eval(ai) {}
+
+	XMCTS(const XMCTS& other) : eval(other.eval) {
+		playouts = other.playouts;
+		threads = other.threads;
+		cpuct = other.cpuct;
+		virtualloss = other.virtualloss;
+		rng = other.rng;
+	}
+
+	static void addValue(std::atomic<double>& a, double v) {
+		double old = a.load();
+		while (!a.compare_exchange_weak(old, old + v));
+	}
+
+	// Squashes a getScore result into a value in (-1, 1). A chariot up is worth about 0.76.
+	double squash(double score) { return std::tanh(score / (eval.values[5] * XAI::SCALE)); }
+
+	// Creates the children of node in random order. Captures get a larger prior, scaled by the value of the victim.
+	void expand(Node* node, XGame& game, XRandom& random) {
+		std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> legals = game.getAllLegalMoves();
+		random.shuffle(legals);
+		if (legals.empty()) {
+			node->terminal = true;
+			node->terminalvalue = -1; // Checkmated or stalemated, both are losses in xiangqi
+		}
+		else if (game.TLE()) {
+			node->terminal = true;
+			node->terminalvalue = 0;
+		}
+
+		double total = 0;
+		for (auto p : legals) {
+			XPiece victim = game.get(p.first.first + p.second.first, p.first.second + p.second.second);
+			std::unique_ptr<Node> child(new Node());
+			child->move = p;
+			child->prior = victim.isEmpty() ? 1 : 1 + eval.values[victim.getID()];
+			total += child->prior;
+			node->children.push_back(std::move(child));
+		}
+		for (auto& child : node->children) child->prior /= total;
+		node->expanded = true;
+	}
+
+	Node* select(Node* node) {
+		double sqrtn = std::sqrt((double)std::max(1, node->visits.load()));
+		Node* best = nullptr;
+		double bestscore = -1 * DBL_MAX;
+		for (auto& child : node->children) {
+			int n = child->visits.load();
+			double q = n ? child->value.load() / n : 0;
+			double u = cpuct * child->prior * sqrtn / (1 + n);
+			if (q + u > bestscore) {
+				bestscore = q + u;
+				best = child.get();
+			}
+		}
+		return best;
+	}
+
+	// One descent from the root to a leaf and back. evaluator and random belong to the calling thread.
+	void playout(XGame game, XAI& evaluator, XRandom& random) {
+		std::vector<Node*> path = {root.get()};
+		Node* node = root.get();
+		double res;
+
+		while (true) {
+			std::unique_lock<std::mutex> guard(node->lock);
+			if (!node->expanded) {
+				node->key = game.hash();
+				expand(node, game, random);
+				guard.unlock();
+				res = node->terminal ? node->terminalvalue : squash(evaluator.getScore(game));
+				break;
+			}
+			if (node->terminal) {
+				res = node->terminalvalue;
+				break;
+			}
+
+			Node* child = select(node);
+			// Virtual loss - make this path look worse to the other threads until the result comes back
+			child->visits++;
+			addValue(child->value, -virtualloss);
+			guard.unlock();
+
+			game.execute(child->move.first, child->move.second);
+			game.sidetomove = !game.sidetomove;
+			path.push_back(child);
+			node = child;
+		}
+
+		// res is from the point of view of the side to move at the leaf, which is the opponent of whoever moved into it
+		for (int i = (int)path.size() - 1; i >= 0; i--) {
+			res = -res;
+			if (i > 0) addValue(path[i]->value, res + virtualloss);
+			else {
+				path[i]->visits++;
+				addValue(path[i]->value, res);
+			}
+		}
+	}
+
+	// Moves the root to the node for game if it is the current root or one of its children (pick() leaves the root on our own move,
+	// so the opponent's reply is a child). Anything else starts a new tree.
+	void advance(XGame& game) {
+		uint64_t key = game.hash();
+		if (root && root->key != key) {
+			std::unique_ptr<Node> found;
+			for (auto& child : root->children) {
+				if (child->expanded && child->key == key) {
+					found = std::move(child);
+					break;
+				}
+			}
+			root = std::move(found);
+		}
+
+		if (root) reused = root->visits.load();
+		else {
+			reused = 0;
+			root.reset(new Node());
+		}
+	}
+
+	std::pair<std::pair<int, int>, std::pair<int, int>> pick(XGame game, bool verbose = false) {
+		advance(game);
+
+		std::atomic<int> remaining(playouts);
+		auto work = [this, &remaining, game](XAI evaluator, uint64_t seed) {
+			XRandom random(seed);
+			while (remaining-- > 0) playout(game, evaluator, random);
+		};
+
+		std::vector<std::thread> workers;
+		for (int i = 1; i < threads; i++) workers.emplace_back(work, eval, rng.next());
+		work(eval, rng.next());
+		for (auto& w : workers) w.join();
+
+		// Most visited move, ties to the better value
+		Node* best = nullptr;
+		for (auto& child : root->children) {
+			if (!best || child->visits > best->visits || (child->visits == best->visits && child->value > best->value)) best = child.get();
+		}
+		if (!best) return {{-1, -1}, {0, 0}}; // No legal moves at the root, the caller has to check for this
+
+		if (verbose) {
+			std::cout << root->visits << " VISITS (" << reused << " REUSED)\n";
+			std::cout << XAI::moveString(best->move) << " " << best->visits << " VISITS Q " << (best->visits ? best->value / best->visits : 0) << "\n";
+		}
+
+		// Keep our move's subtree so the next pick can pick up from the opponent's reply
+		auto move = best->move;
+		for (auto& child : root->children) {
+			if (child.get() == best) {
+				std::unique_ptr<Node> next = std::move(child);
+				root = std::move(next);
+				break;
+			}
+		}
+		return move;
+	}
+};
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "xiangqi.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define XNNUE_AVX2
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define XNNUE_SSE4
+#endif
+
+// Small efficiently updatable neural network, an alternative to XAI's weighted features (see XAI::network).
+//
+// Inputs are (general bucket, piece kind, square) as seen from one color's perspective, with ranks mirrored for black the same way as
+// the piece-square tables (XGame::pstSquare). The bucket is where that color's own general stands in its palace (9 squares), and the
+// kind is the piece ID (2 .. 8) for the perspective's own pieces or 7 + ID for the other side's, so the enemy general is an input but
+// the own general is not. Both perspectives share one first layer of HIDDEN int16 neurons. The search keeps the first layer sums for
+// both (XAccumulator) at every ply and adds or subtracts one weight row per piece that moves, only rebuilding a perspective when its
+// general moves.
+// The output is a single neuron over the side to move's clipped sums followed by the other side's:
+//   score = (sum of clamp(acc, 0, QA) * weight + bias) * scale / (QA * QB)
+// in eval units (XAI::SCALE per pawn).
+//
+// Built with -mavx2 or -msse4.1 the kernels use those instructions, otherwise (e.g. on the ESP32) they are plain loops. All of them
+// give the same result.
+//
+// The weight file, in host byte order like the opening book:
+//   char     magic[4]      "XQNN"
+//   uint32   version       1
+//   uint32   hidden        must equal HIDDEN
+//   int32    scale
+//   int16    ftbias[HIDDEN]
+//   int16    ftweights[INPUTS][HIDDEN]
+//   int16    outweights[2 * HIDDEN]   Side to move's half first
+//   int32    outbias
+class XNetwork {
+	public:
+	static const int HIDDEN = 128;
+	static const int BUCKETS = 9;
+	static const int KINDS = 14;
+	static const int INPUTS = BUCKETS * KINDS * 90;
+	static const int QA = 255; // Clipping bound of the first layer
+	static const int QB = 64; // Fixed-point scale of the output weights
+	static const uint32_t VERSION = 1;
+
+	std::vector<int16_t> ftweights; // INPUTS rows of HIDDEN
+	int16_t ftbias[HIDDEN] = {0};
+	int16_t outweights[2 * HIDDEN] = {0};
+	int32_t outbias = 0;
+	int32_t scale = 0;
+	uint64_t id = 0; // Hash of the file contents, so engines with different networks do not share cached evals
+
+	XNetwork() {}
+	XNetwork(const std::string& path) { load(path); }
+	XNetwork(const XNetwork&) = delete;
+	XNetwork& operator=(const XNetwork&) = delete;
+
+	// Returns false, leaving the network empty, if the file is missing, truncated or for another layout
+	bool load(const std::string& path) {
+		ftweights.clear();
+		id = 0;
+		std::ifstream in(path, std::ios::binary);
+		if (!in) return false;
+		std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		size_t expected = 16 + sizeof(ftbias) + (size_t)INPUTS * HIDDEN * sizeof(int16_t) + sizeof(outweights) + sizeof(outbias);
+		if (data.size() != expected || std::memcmp(data.data(), "XQNN", 4) != 0) return false;
+		uint32_t version, hidden;
+		std::memcpy(&version, &data[4], 4);
+		std::memcpy(&hidden, &data[8], 4);
+		if (version != VERSION || hidden != HIDDEN) return false;
+
+		const char* p = data.data() + 12;
+		auto read = [&p](void* dst, size_t n) {
+			std::memcpy(dst, p, n);
+			p += n;
+		};
+		read(&scale, sizeof(scale));
+		read(ftbias, sizeof(ftbias));
+		ftweights.resize((size_t)INPUTS * HIDDEN);
+		read(ftweights.data(), ftweights.size() * sizeof(int16_t));
+		read(outweights, sizeof(outweights));
+		read(&outbias, sizeof(outbias));
+
+		id = 14695981039346656037ULL; // FNV-1a
+		for (char c : data) {
+			id ^= (uint8_t)c;
+			id *= 1099511628211ULL;
+		}
+		return true;
+	}
+
+	bool loaded() const { return !ftweights.empty(); }
+
+	// Writes the file load() reads
+	bool save(const std::string& path) const {
+		std::ofstream out(path, std::ios::binary);
+		uint32_t version = VERSION;
+		uint32_t hidden = HIDDEN;
+		out.write("XQNN", 4);
+		out.write((const char*)&version, 4);
+		out.write((const char*)&hidden, 4);
+		out.write((const char*)&scale, sizeof(scale));
+		out.write((const char*)ftbias, sizeof(ftbias));
+		out.write((const char*)ftweights.data(), ftweights.size() * sizeof(int16_t));
+		out.write((const char*)outweights, sizeof(outweights));
+		out.write((const char*)&outbias, sizeof(outbias));
+		return (bool)out;
+	}
+
+	// Small random weights, to check the incremental updates without a trained network (see bench)
+	void randomize(XRandom& rng) {
+		scale = 400;
+		for (auto& b : ftbias) b = (int16_t)(rng.nextInt(129) - 64);
+		ftweights.resize((size_t)INPUTS * HIDDEN);
+		for (auto& w : ftweights) w = (int16_t)(rng.nextInt(81) - 40);
+		for (auto& w : outweights) w = (int16_t)(rng.nextInt(255) - 127);
+		outbias = 0;
+		id = rng.next();
+	}
+
+	// sq is the perspective's own square (9 * rank + file), as returned by XGame::pstSquare
+	static int bucket(int sq) {
+		int x = sq % 9, y = sq / 9;
+		if (x < 3 || x > 5 || y > 2) return 0; // Only off the palace in hand-edited positions
+		return 3 * y + x - 3;
+	}
+
+	static int feature(int bucket, bool own, int id, int sq) { return (bucket * KINDS + (own ? 0 : 7) + id - 2) * 90 + sq; }
+
+	const int16_t* row(int feature) const { return ftweights.data() + (size_t)feature * HIDDEN; }
+
+	static void add(int16_t* acc, const int16_t* row) {
+#if defined(XNNUE_AVX2)
+		for (int i = 0; i < HIDDEN; i += 16) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+			__m256i w = _mm256_loadu_si256((const __m256i*)(row + i));
+			_mm256_storeu_si256((__m256i*)(acc + i), _mm256_add_epi16(a, w));
+		}
+#elif defined(XNNUE_SSE4)
+		for (int i = 0; i < HIDDEN; i += 8) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(acc + i));
+			__m128i w = _mm_loadu_si128((const __m128i*)(row + i));
+			_mm_storeu_si128((__m128i*)(acc + i), _mm_add_epi16(a, w));
+		}
+#else
+		for (int i = 0; i < HIDDEN; i++) acc[i] = (int16_t)(acc[i] + row[i]);
+#endif
+	}
+
+	static void sub(int16_t* acc, const int16_t* row) {
+#if defined(XNNUE_AVX2)
+		for (int i = 0; i < HIDDEN; i += 16) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+			__m256i w = _mm256_loadu_si256((const __m256i*)(row + i));
+			_mm256_storeu_si256((__m256i*)(acc + i), _mm256_sub_epi16(a, w));
+		}
+#elif defined(XNNUE_SSE4)
+		for (int i = 0; i < HIDDEN; i += 8) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(acc + i));
+			__m128i w = _mm_loadu_si128((const __m128i*)(row + i));
+			_mm_storeu_si128((__m128i*)(acc + i), _mm_sub_epi16(a, w));
+		}
+#else
+		for (int i = 0; i < HIDDEN; i++) acc[i] = (int16_t)(acc[i] - row[i]);
+#endif
+	}
+
+	// Sum of clamp(acc, 0, QA) * weights over one half of the output layer
+	static int32_t output(const int16_t* acc, const int16_t* weights) {
+#if defined(XNNUE_AVX2)
+		__m256i zero = _mm256_setzero_si256();
+		__m256i qa = _mm256_set1_epi16(QA);
+		__m256i sum = zero;
+		for (int i = 0; i < HIDDEN; i += 16) {
+			__m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+			__m256i w = _mm256_loadu_si256((const __m256i*)(weights + i));
+			a = _mm256_min_epi16(_mm256_max_epi16(a, zero), qa);
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, w));
+		}
+		__m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		s = _mm_hadd_epi32(s, s);
+		s = _mm_hadd_epi32(s, s);
+		return _mm_cvtsi128_si32(s);
+#elif defined(XNNUE_SSE4)
+		__m128i zero = _mm_setzero_si128();
+		__m128i qa = _mm_set1_epi16(QA);
+		__m128i sum = zero;
+		for (int i = 0; i < HIDDEN; i += 8) {
+			__m128i a = _mm_loadu_si128((const __m128i*)(acc + i));
+			__m128i w = _mm_loadu_si128((const __m128i*)(weights + i));
+			a = _mm_min_epi16(_mm_max_epi16(a, zero), qa);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(a, w));
+		}
+		sum = _mm_hadd_epi32(sum, sum);
+		sum = _mm_hadd_epi32(sum, sum);
+		return _mm_cvtsi128_si32(sum);
+#else
+		int32_t sum = 0;
+		for (int i = 0; i < HIDDEN; i++) sum += std::min(std::max((int32_t)acc[i], 0), (int32_t)QA) * weights[i];
+		return sum;
+#endif
+	}
+};
+
+// First layer sums of an XNetwork for both perspectives of one position. XAI keeps one per ply of the search (see XAI::Arena).
+struct XAccumulator {
+	int16_t v[2][XNetwork::HIDDEN]; // By perspective, 1 = red
+	int bucket[2]; // Where each perspective's general stands
+
+	// Rebuilds both perspectives from game's board
+	void refresh(const XNetwork& net, XGame& game) {
+		refresh(net, game, true);
+		refresh(net, game, false);
+	}
+
+	// Rebuilds one perspective. Every input depends on where that side's general stands, so this is needed whenever it moves.
+	void refresh(const XNetwork& net, XGame& game, bool red) {
+		bucket[red] = 0;
+		for (int x = 0; x < 9; x++) {
+			for (int y = 0; y < 10; y++) {
+				XPiece piece = game.board[x][y];
+				if (piece.isGeneral() && piece.getColor() == red) bucket[red] = XNetwork::bucket(XGame::pstSquare(red, x, y));
+			}
+		}
+		std::memcpy(v[red], net.ftbias, sizeof(v[red]));
+		for (int x = 0; x < 9; x++) {
+			for (int y = 0; y < 10; y++) {
+				XPiece piece = game.board[x][y];
+				bool own = piece.getColor() == red;
+				if (piece.isEmpty() || (own && piece.isGeneral())) continue;
+				XNetwork::add(v[red], net.row(XNetwork::feature(bucket[red], own, piece.getID(), XGame::pstSquare(red, x, y))));
+			}
+		}
+	}
+
+	// The sums for child, the position after move p was executed on the one parent holds
+	void update(const XNetwork& net, const XAccumulator& parent, XGame& child, std::pair<std::pair<int, int>, std::pair<int, int>> p) {
+		*this = parent;
+		int dx = p.first.first + p.second.first;
+		int dy = p.first.second + p.second.second;
+		XPiece piece = child.get(dx, dy);
+		if (!child.captures.empty()) add(net, child.captures[0], dx, dy, -1);
+		add(net, piece, p.first.first, p.first.second, -1);
+		add(net, piece, dx, dy, 1);
+		// A general that moves or is taken changes its side's bucket
+		if (piece.isGeneral()) refresh(net, child, piece.getColor());
+		if (!child.captures.empty() && child.captures[0].isGeneral()) refresh(net, child, child.captures[0].getColor());
+	}
+
+	// Adds (sign 1) or removes (sign -1) piece on (x, y) in both perspectives. A general is not an input of its own perspective.
+	void add(const XNetwork& net, XPiece piece, int x, int y, int sign) {
+		for (int p = 0; p < 2; p++) {
+			bool own = piece.getColor() == (bool)p;
+			if (own && piece.isGeneral()) continue;
+			const int16_t* row = net.row(XNetwork::feature(bucket[p], own, piece.getID(), XGame::pstSquare(p, x, y)));
+			if (sign > 0) XNetwork::add(v[p], row);
+			else XNetwork::sub(v[p], row);
+		}
+	}
+
+	// Score from the side to move's perspective, in eval units
+	int evaluate(const XNetwork& net, bool stm) const {
+		int64_t sum = (int64_t)XNetwork::output(v[stm], net.outweights) + XNetwork::output(v[!stm], net.outweights + XNetwork::HIDDEN) + net.outbias;
+		return (int)(sum * net.scale / (XNetwork::QA * XNetwork::QB));
+	}
+};
+
+#endif
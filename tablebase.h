@@ -0,0 +1,418 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "xiangqi.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define XTABLEBASE_MMAP
+#endif
+
+// Endgame tablebases for small material sets, built by retrograde analysis over the engine's own move generator.
+// A material set is written red pieces, dash, black pieces, e.g. "GR-GAA" is general and chariot against general and two advisors.
+// Letters are the piece symbols: G general, A advisor, E elephant, H horse, R chariot, C cannon, S soldier.
+//
+// Every table is a file "<set>.xtb", in host byte order like the opening book:
+//   char     magic[4]    "XQTB"
+//   uint32   version     Files from another version are rejected, and generate() writes them again
+//   uint64   positions
+//   uint8    values[positions]
+//     0          draw (also used for unreachable positions)
+//     1 .. 127   side to move mates in that many plies
+//     128 + n    side to move gets mated in n plies
+// Positions are indexed by side to move and then each piece's square, taken from the squares it can actually stand on (palace for
+// generals and advisors, the seven elephant points). The board is mirrored left to right so that the red general is never on the
+// right hand file of the palace, which saves a third of the space. Red and black are not swapped because the move generator is not
+// color-symmetric. Files are mapped read-only where mmap is available.
+//
+// Generating keeps every move of every position of the table in memory, 4 bytes each, on top of 6 bytes per position. That comes to
+// about 12 bytes per position: 140 MB for the 11.9M positions of GR-GAAEE. Every piece more multiplies the count by up to 90.
+class XTablebase {
+	public:
+	static const int LOSS = -1;
+	static const int DRAW = 0;
+	static const int WIN = 1;
+	static const int MISSING = 2;
+	static const uint32_t VERSION = 1;
+	static const size_t HEADER = 16;
+
+	struct Table {
+		std::string name;
+		std::vector<uint16_t> pieces; // Piece values in index order, red first
+		std::vector<std::vector<int>> domains; // Squares (9 * rank + file) each piece can stand on, ascending
+		std::vector<std::vector<int>> slots; // Square -> position in the piece's domain, -1 if it cannot stand there
+		size_t size = 0;
+		const uint8_t* data = nullptr;
+
+		std::vector<uint8_t> owned; // Used instead of a mapping while generating or where there is no mmap
+		void* mapped = nullptr;
+		size_t mappedsize = 0;
+
+		~Table() {
+#ifdef XTABLEBASE_MMAP
+			if (mapped) munmap(mapped, mappedsize);
+#endif
+		}
+	};
+
+	std::string dir = ".";
+	std::map<uint64_t, std::unique_ptr<Table>> tables; // By material()
+	int maxpieces = 0; // Largest loaded set, positions with more pieces skip the lookup
+
+	XTablebase() {}
+	XTablebase(const std::string& d) : dir(d) {}
+	XTablebase(const XTablebase&) = delete;
+	XTablebase& operator=(const XTablebase&) = delete;
+
+	static int order(int bit) { // G A E H R C S
+		int res[9] = {0, 0, 6, 3, 2, 4, 1, 0, 5};
+		return res[bit];
+	}
+
+	// Counts of every colored piece type, 3 bits each
+	static uint64_t material(XGame& game, int& count) {
+		uint64_t res = 0;
+		count = 0;
+		for (int x = 0; x < 9; x++) {
+			for (int y = 0; y < 10; y++) {
+				XPiece piece = game.board[x][y];
+				if (piece.isEmpty()) continue;
+				res += 1ULL << (3 * ((piece.getColor() ? 0 : 7) + order(piece.getID())));
+				count++;
+			}
+		}
+		return res;
+	}
+
+	static uint64_t material(std::vector<uint16_t>& pieces) {
+		uint64_t res = 0;
+		for (auto p : pieces) res += 1ULL << (3 * ((XPiece(p).getColor() ? 0 : 7) + order(XPiece(p).getID())));
+		return res;
+	}
+
+	// "GR-G" -> piece values in index order. Each side needs exactly one general.
+	static bool parse(const std::string& name, std::vector<uint16_t>& pieces) {
+		std::string letters = "SHERAGC";
+		pieces.clear();
+		size_t dash = name.find('-');
+		if (dash == std::string::npos) return false;
+		for (int side = 0; side < 2; side++) {
+			std::string part = side ? name.substr(dash + 1) : name.substr(0, dash);
+			std::vector<uint16_t> own;
+			int generals = 0;
+			for (char c : part) {
+				size_t i = letters.find(c);
+				if (i == std::string::npos) return false;
+				own.push_back((side ? (1<<1) : (1<<0)) | (1 << (i + 2)));
+				if (c == 'G') generals++;
+			}
+			if (generals != 1) return false;
+			std::sort(own.begin(), own.end(), [](uint16_t a, uint16_t b) { return order(XPiece(a).getID()) < order(XPiece(b).getID()); });
+			pieces.insert(pieces.end(), own.begin(), own.end());
+		}
+		return true;
+	}
+
+	static std::string name(std::vector<uint16_t>& pieces) {
+		std::string res;
+		bool black = false;
+		for (auto p : pieces) {
+			XPiece piece(p);
+			if (!piece.getColor() && !black) {
+				res += '-';
+				black = true;
+			}
+			res += piece.ids[piece.getID()];
+		}
+		return res;
+	}
+
+	static std::vector<int> domain(uint16_t value, bool canonical) {
+		XPiece piece(value);
+		bool red = piece.getColor();
+		std::vector<int> res;
+		for (int y = 0; y < 10; y++) {
+			for (int x = 0; x < 9; x++) {
+				int ry = red ? y : 9 - y; // Rank from the piece's own side
+				bool palace = x >= 3 && x <= 5 && ry <= 2;
+				if (piece.isGeneral() && (!palace || (canonical && x == 5))) continue;
+				if (piece.isAdvisor() && (!palace || (x == 4) != (ry == 1))) continue;
+				if (piece.isElephant() && !(ry <= 4 && ry % 2 == 0 && x % 2 == 0 && (x + ry) % 4 == 2)) continue;
+				res.push_back(9 * y + x);
+			}
+		}
+		return res;
+	}
+
+	static void setup(Table& t, std::vector<uint16_t>& pieces) {
+		t.name = name(pieces);
+		t.pieces = pieces;
+		t.domains.clear();
+		t.slots.clear();
+		t.size = 2;
+		for (int i = 0; i < (int)pieces.size(); i++) {
+			t.domains.push_back(domain(pieces[i], i == 0)); // The red general comes first
+			std::vector<int> slot(90, -1);
+			for (int k = 0; k < (int)t.domains[i].size(); k++) slot[t.domains[i][k]] = k;
+			t.slots.push_back(slot);
+			t.size *= t.domains[i].size();
+		}
+	}
+
+	// Index of game in t, or -1 if some piece is off its domain. Identical pieces are taken in ascending square order.
+	static int64_t index(Table& t, XGame& game) {
+		bool mirror = false;
+		for (int y = 0; y < 3; y++) {
+			if (game.board[5][y].value == t.pieces[0]) mirror = true;
+		}
+
+		int64_t res = game.sidetomove ? 0 : 1;
+		int i = 0;
+		while (i < (int)t.pieces.size()) {
+			int squares[5];
+			int n = 0;
+			for (int x = 0; x < 9; x++) {
+				for (int y = 0; y < 10; y++) {
+					if (game.board[x][y].value != t.pieces[i] || n >= 5) continue;
+					int sq = 9 * y + (mirror ? 8 - x : x);
+					int k = n++;
+					for (; k > 0 && squares[k - 1] > sq; k--) squares[k] = squares[k - 1];
+					squares[k] = sq;
+				}
+			}
+			for (int k = 0; k < n; k++, i++) {
+				if (i >= (int)t.pieces.size() || t.pieces[i] != t.pieces[i - k] || t.slots[i][squares[k]] < 0) return -1;
+				res = res * t.domains[i].size() + t.slots[i][squares[k]];
+			}
+			if (n == 0) return -1;
+		}
+		return res;
+	}
+
+	// Sets up the position with index i. Returns false if two pieces share a square.
+	static bool decode(Table& t, int64_t i, XGame& game) {
+		for (int x = 0; x < 9; x++) {
+			for (int y = 0; y < 10; y++) game.board[x][y] = XPiece();
+		}
+		for (int k = (int)t.pieces.size() - 1; k >= 0; k--) {
+			int n = t.domains[k].size();
+			int sq = t.domains[k][i % n];
+			i /= n;
+			if (!game.board[sq % 9][sq / 9].isEmpty()) return false;
+			game.board[sq % 9][sq / 9] = XPiece(t.pieces[k]);
+		}
+		game.sidetomove = (i == 0);
+		game.halfmoveclock = 0;
+		game.rehash();
+		return true;
+	}
+
+	static int result(uint8_t b, int& dtm) {
+		if (b == 0) {
+			dtm = 0;
+			return DRAW;
+		}
+		if (b < 128) {
+			dtm = b;
+			return WIN;
+		}
+		dtm = b - 128;
+		return LOSS;
+	}
+
+	// Exact result for the side to move and the distance to mate in plies. MISSING if there is no table for this material.
+	int probe(XGame& game, int& dtm) {
+		int count;
+		uint64_t key = material(game, count);
+		if (count > maxpieces) return MISSING;
+		auto it = tables.find(key);
+		if (it == tables.end()) return MISSING;
+		int64_t i = index(*it->second, game);
+		if (i < 0) return MISSING;
+		return result(it->second->data[i], dtm);
+	}
+
+	// probe(), except that a win or loss that cannot be mated before the move limit (XGame::TLE) is MISSING. The limit may draw it,
+	// but a capture on the way resets the clock, so it is left to the search instead of being called a draw.
+	int probeInTime(XGame& game, int& dtm) {
+		int r = probe(game, dtm);
+		if ((r == WIN || r == LOSS) && dtm > game.maxmoves - game.halfmoveclock) return MISSING;
+		return r;
+	}
+
+	bool load(const std::string& set) {
+		std::unique_ptr<Table> t(new Table());
+		std::vector<uint16_t> pieces;
+		if (!parse(set, pieces)) return false;
+		setup(*t, pieces);
+		std::string path = dir + "/" + t->name + ".xtb";
+#ifdef XTABLEBASE_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && (size_t)st.st_size == HEADER + t->size) {
+			void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				t->mapped = p;
+				t->mappedsize = st.st_size;
+				if (header(*t, (const char*)p)) t->data = (const uint8_t*)p + HEADER;
+			}
+		}
+		::close(fd);
+#else
+		std::ifstream in(path, std::ios::binary);
+		char head[HEADER];
+		t->owned.resize(t->size);
+		if (in.read(head, HEADER) && header(*t, head) && in.read((char*)t->owned.data(), t->size) && in.peek() == std::ifstream::traits_type::eof()) t->data = t->owned.data();
+#endif
+		if (!t->data) return false;
+		add(std::move(t));
+		return true;
+	}
+
+	// Generates the table for set, and first every smaller set a capture can lead to. Sets that already have a file are loaded instead.
+	bool generate(const std::string& set, bool verbose = false) {
+		std::vector<uint16_t> pieces;
+		if (!parse(set, pieces)) return false;
+		uint64_t key = material(pieces);
+		if (tables.count(key)) return true;
+		if (load(set)) {
+			if (verbose) std::cout << "LOADED " << set << "\n";
+			return true;
+		}
+
+		for (int i = 0; i < (int)pieces.size(); i++) {
+			if (XPiece(pieces[i]).isGeneral()) continue;
+			std::vector<uint16_t> sub = pieces;
+			sub.erase(sub.begin() + i);
+			if (!generate(name(sub), verbose)) return false;
+		}
+
+		std::unique_ptr<Table> t(new Table());
+		setup(*t, pieces);
+		if (t->size > CAPTURE) return false; // Indices would run into the captures in solve()
+		solve(*t, verbose);
+
+		std::ofstream out(dir + "/" + t->name + ".xtb", std::ios::binary);
+		uint32_t version = VERSION;
+		uint64_t positions = t->size;
+		out.write("XQTB", 4);
+		out.write((const char*)&version, 4);
+		out.write((const char*)&positions, 8);
+		out.write((const char*)t->owned.data(), t->size);
+		if (!out) return false;
+		out.close();
+		if (load(set)) return true; // Switch over to the mapped file
+		add(std::move(t));
+		return true;
+	}
+
+	private:
+	// Whether a file starts with the header this build writes for t
+	static bool header(Table& t, const char* head) {
+		uint32_t version;
+		uint64_t positions;
+		std::memcpy(&version, head + 4, 4);
+		std::memcpy(&positions, head + 8, 8);
+		return std::memcmp(head, "XQTB", 4) == 0 && version == VERSION && positions == t.size;
+	}
+
+	void add(std::unique_ptr<Table> t) {
+		maxpieces = std::max(maxpieces, (int)t->pieces.size());
+		tables[material(t->pieces)] = std::move(t);
+	}
+
+	static const uint32_t CAPTURE = 0xFFFFFF00;
+
+	// Retrograde analysis. Moves into the same table are stored as indices and captures as CAPTURE + the final byte of the smaller table.
+	// Pass k then settles every position that is decided in exactly k plies: wins need a child lost in k - 1, losses need every child
+	// won, the slowest in k - 1. Whatever is left when the passes stop changing anything is a draw.
+	void solve(Table& t, bool verbose) {
+		t.owned.assign(t.size, 0);
+		t.data = t.owned.data();
+		std::vector<uint8_t>& values = t.owned;
+		std::vector<uint8_t> open(t.size, 0);
+		std::vector<uint32_t> start(t.size + 1, 0);
+		std::vector<uint32_t> children;
+		int deepest = 0;
+
+		XGame game;
+		XMoveList moves;
+		for (int64_t i = 0; i < (int64_t)t.size; i++) {
+			start[i] = children.size();
+			if (!decode(t, i, game) || index(t, game) != i) continue;
+			XGame other(game);
+			other.sidetomove = !other.sidetomove;
+			if (!other.noChecks()) continue; // The side that just moved is in check, not a real position
+
+			game.getAllLegalMoves(moves);
+			if (moves.empty()) { // No legal moves loses, in check or not, as everywhere else in the engine
+				values[i] = 128;
+				continue;
+			}
+			for (auto p : moves) {
+				XGame game2(game);
+				game2.execute(p.first, p.second);
+				game2.sidetomove = !game2.sidetomove;
+				int count;
+				if (material(game2, count) == material(t.pieces)) {
+					int64_t c = index(t, game2);
+					children.push_back(c >= 0 ? (uint32_t)c : CAPTURE + 0); // Never off the domains, but that would count as a draw
+				}
+				else {
+					int dtm = 0;
+					int r = probe(game2, dtm);
+					uint8_t b = (r == WIN) ? dtm : ((r == LOSS) ? 128 + dtm : 0);
+					children.push_back(CAPTURE + b);
+					deepest = std::max(deepest, dtm);
+				}
+			}
+			open[i] = 1;
+		}
+		start[t.size] = children.size();
+
+		int quiet = 0;
+		for (int k = 1; k < 128 && (quiet < 2 || k <= deepest + 2); k++) {
+			int settled = 0;
+			for (int64_t i = 0; i < (int64_t)t.size; i++) {
+				if (!open[i]) continue;
+				bool win = false;
+				bool allwon = true;
+				for (uint32_t c = start[i]; c < start[i + 1]; c++) {
+					uint32_t child = children[c];
+					uint8_t b = (child < CAPTURE) ? values[child] : (uint8_t)(child - CAPTURE);
+					if (child < CAPTURE && open[child]) b = 0;
+					int dtm;
+					int r = result(b, dtm);
+					if (r == LOSS && dtm <= k - 1) win = true;
+					if (r != WIN || dtm > k - 1) allwon = false;
+				}
+				if ((k & 1) && win) values[i] = k;
+				else if (!(k & 1) && allwon) values[i] = 128 + k;
+				else continue;
+				settled++;
+			}
+			// Settle after the pass so every position in it only saw children from earlier passes
+			for (int64_t i = 0; i < (int64_t)t.size; i++) {
+				if (open[i] && values[i]) open[i] = 0;
+			}
+			quiet = settled ? 0 : quiet + 1;
+			if (verbose && settled) std::cout << t.name << " PLY " << k << " " << settled << " POSITIONS\n";
+		}
+		if (verbose) std::cout << t.name << " DONE, " << t.size << " POSITIONS\n";
+	}
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include <iostream>
+#include "xiangqi.h"
+#include "tablebase.h"
+
+// Endgame tablebase generator. Writes <set>.xtb for every set given and every smaller set they need into dir.
+// Usage: tbgen <dir> <set>...  e.g. tbgen . GR-G GR-GA GR-GAA. Building a table takes about 12 bytes of memory per position
+// (see XTablebase).
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::cout << "USAGE: tbgen <dir> <set>...\n";
+		return 1;
+	}
+
+	XTablebase tb(argv[1]);
+	for (int i = 2; i < argc; i++) {
+		if (!tb.generate(argv[i], true)) {
+			std::cout << "COULD NOT GENERATE " << argv[i] << "\n";
+			return 1;
+		}
+	}
+
+	// Summary of each table
+	for (auto& t : tb.tables) {
+		long long wins = 0, losses = 0;
+		int longest = 0;
+		for (size_t i = 0; i < t.second->size; i++) {
+			int dtm;
+			int r = XTablebase::result(t.second->data[i], dtm);
+			if (r == XTablebase::WIN) wins++;
+			if (r == XTablebase::LOSS) losses++;
+			longest = std::max(longest, dtm);
+		}
+		std::cout << t.second->name << " POSITIONS " << t.second->size << " WINS " << wins << " LOSSES " << losses << " LONGEST MATE " << longest << " PLIES\n";
+	}
+	return 0;
+}